@@ -9,10 +9,21 @@ QT       += core gui
 TARGET = FingerPrint
 TEMPLATE = app
 
+CONFIG += c++11
+
+# per-stage timing in the library (profile.h); remove to compile it out
+DEFINES += FVS_PROFILE
+
+# single-precision direction and frequency fields (fvstypes.h), half the memory
+# DEFINES += FVS_FIELD_FLOAT32
+
 
 SOURCES += main.cpp\
         widget.cpp \
+    batch.cpp \
+    bitimage.cpp \
     export.cpp \
+    fft.cpp \
     file.cpp \
     floatfield.cpp \
     histogram.cpp \
@@ -21,12 +32,21 @@ SOURCES += main.cpp\
     img_base.cpp \
     img_enhance.cpp \
     img_morphology.cpp \
+    img_thinning.cpp \
     import.cpp \
     matching.cpp \
-    minutia.cpp
+    minutia.cpp \
+    parallel.cpp \
+    orientation.cpp \
+    pipeline.cpp \
+    profile.cpp \
+    sampler.cpp
 
 HEADERS  += widget.h \
+    batch.h \
+    bitimage.h \
     export.h \
+    fft.h \
     file.h \
     floatfield.h \
     fvs.h \
@@ -37,7 +57,12 @@ HEADERS  += widget.h \
     img_base.h \
     import.h \
     matching.h \
-    minutia.h
+    minutia.h \
+    orientation.h \
+    parallel.h \
+    pipeline.h \
+    profile.h \
+    sampler.h
 
 FORMS    += widget.ui
 
@@ -0,0 +1,501 @@
+
+/*#############################################################################
+ * 文件名：batch.cpp
+ * 功能：  多幅图像的流水线处理，各阶段在自己的线程中同时处理不同的图像
+#############################################################################*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "batch.h"
+#include "parallel.h"
+
+
+#define BATCH_QUEUE_SIZE    2
+
+
+/* 一个缓冲区和它当前所属的图像 */
+typedef struct iBatchSlot_t {
+    FvsPipelineData_t           data;
+    FvsInt_t                    index;
+    FvsError_t                  result;
+    std::vector<FvsUint64_t>    times;     /* 各级的处理时间 */
+} iBatchSlot_t;
+
+
+/******************************************************************************
+** 两级之间的有界队列，保存缓冲区的序号。
+** 每幅图像在每级只入队出队一次，和毫秒级的处理时间相比，
+** 加锁的代价可以忽略，所以使用和 parallel.cpp 相同的互斥量和条件变量，
+** 空闲时线程睡眠而不是自旋。
+******************************************************************************/
+typedef struct iBatchQueue_t {
+    std::mutex                  lock;
+    std::condition_variable     readable;
+    std::condition_variable     writable;
+    std::vector<FvsInt_t>       ring;
+    FvsInt_t                    head;
+    FvsInt_t                    count;
+    FvsInt_t                    producers; /* 上一级尚未退出的线程，为0时不再有输入 */
+    FvsInt_t                    maxDepth;
+    FvsUint64_t                 depthSum;
+    FvsUint64_t                 samples;
+
+    iBatchQueue_t() : head(0), count(0), producers(0), maxDepth(0),
+        depthSum(0), samples(0) {}
+} iBatchQueue_t;
+
+
+/* 一级的线程数和统计 */
+typedef struct iBatchStage_t {
+    FvsInt_t                    threads;
+    std::atomic<FvsUint64_t>    items;
+    std::atomic<FvsUint64_t>    busy;
+    std::atomic<FvsUint64_t>    starved;
+    std::atomic<FvsUint64_t>    blocked;
+
+    iBatchStage_t() : threads(1), items(0), busy(0), starved(0), blocked(0) {}
+} iBatchStage_t;
+
+
+/* 批处理对象，queues[s] 是第 s 级的输入，queues[0] 是空闲的缓冲区 */
+typedef struct iFvsBatch_t {
+    FvsPipeline_t               pipeline;
+    FvsInt_t                    stages;
+    FvsInt_t                    minutiae;
+    FvsInt_t                    queueSize;
+    FvsInt_t                    bufferCount;
+    iBatchStage_t*              stage;
+    iBatchQueue_t*              queues;
+    std::vector<iBatchSlot_t*>  slots;
+    /* 当前的运行 */
+    std::atomic<bool>           cancel;
+    std::atomic<FvsInt_t>       next;
+    FvsInt_t                    count;
+    FvsBatchSource_t            source;
+    FvsBatchSink_t              sink;
+    FvsPointer_t                context;
+} iFvsBatch_t;
+
+
+static FvsUint64_t BatchNow() {
+    return (FvsUint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+static void QueueReset(iBatchQueue_t* q, const FvsInt_t capacity, const FvsInt_t producers) {
+    q->ring.assign((size_t)capacity, 0);
+    q->head      = 0;
+    q->count     = 0;
+    q->producers = producers;
+    q->maxDepth  = 0;
+    q->depthSum  = 0;
+    q->samples   = 0;
+}
+
+
+/* 入队，队列满时等待，等待的时间加到 waited 上 */
+static void QueuePush(iBatchQueue_t* q, const FvsInt_t slot, FvsUint64_t* waited) {
+    std::unique_lock<std::mutex> guard(q->lock);
+    FvsInt_t capacity = (FvsInt_t)q->ring.size();
+    if (q->count == capacity) {
+        FvsUint64_t t = BatchNow();
+        while (q->count == capacity)
+            q->writable.wait(guard);
+        *waited += BatchNow() - t;
+    }
+    q->ring[(q->head + q->count) % capacity] = slot;
+    q->count++;
+    if (q->count > q->maxDepth)
+        q->maxDepth = q->count;
+    q->depthSum += q->count;
+    q->samples++;
+    q->readable.notify_one();
+}
+
+
+/* 出队，队列空时等待；上一级的线程都已退出并且队列为空时返回false */
+static bool QueuePop(iBatchQueue_t* q, FvsInt_t* slot, FvsUint64_t* waited) {
+    std::unique_lock<std::mutex> guard(q->lock);
+    if (q->count == 0) {
+        FvsUint64_t t = BatchNow();
+        while (q->count == 0 && q->producers > 0)
+            q->readable.wait(guard);
+        *waited += BatchNow() - t;
+        if (q->count == 0)
+            return false;
+    }
+    *slot = q->ring[q->head];
+    q->head = (q->head + 1) % (FvsInt_t)q->ring.size();
+    q->count--;
+    q->writable.notify_one();
+    return true;
+}
+
+
+static void QueueProducerDone(iBatchQueue_t* q) {
+    std::lock_guard<std::mutex> guard(q->lock);
+    if (--q->producers == 0)
+        q->readable.notify_all();
+}
+
+
+static void BatchDestroySlot(iBatchSlot_t* slot) {
+    ImageDestroy(slot->data.image);
+    FloatFieldDestroy(slot->data.direction);
+    FloatFieldDestroy(slot->data.frequency);
+    ImageDestroy(slot->data.mask);
+    BitImageDestroy(slot->data.bits);
+    MinutiaSetDestroy(slot->data.minutia);
+    delete slot;
+}
+
+
+static iBatchSlot_t* BatchCreateSlot(const FvsInt_t stages, const FvsInt_t minutiae) {
+    iBatchSlot_t* slot = new (std::nothrow) iBatchSlot_t;
+    if (slot == NULL)
+        return NULL;
+    slot->data.image     = ImageCreate();
+    slot->data.direction = FloatFieldCreate();
+    slot->data.frequency = FloatFieldCreate();
+    slot->data.mask      = ImageCreate();
+    slot->data.bits      = BitImageCreate();
+    slot->data.minutia   = MinutiaSetCreate(minutiae);
+    slot->index  = -1;
+    slot->result = FvsOK;
+    slot->times.assign((size_t)stages, 0);
+    if (slot->data.image == NULL || slot->data.direction == NULL ||
+            slot->data.frequency == NULL || slot->data.mask == NULL ||
+            slot->data.bits == NULL || slot->data.minutia == NULL) {
+        BatchDestroySlot(slot);
+        return NULL;
+    }
+    return slot;
+}
+
+
+/* 第 s 级的一个线程：取一个缓冲区，处理后交给下一级 */
+static void BatchWorker(iFvsBatch_t* p, const FvsInt_t s) {
+    iBatchStage_t* stage = &p->stage[s];
+    iBatchSlot_t* slot;
+    FvsUint64_t starved, blocked, t;
+    FvsInt_t id, index;
+    bool last = (s == p->stages - 1);
+    for (;;) {
+        starved = 0;
+        if (!QueuePop(&p->queues[s], &id, &starved))
+            break;
+        stage->starved += starved;
+        slot = p->slots[id];
+        if (s == 0) {
+            /* 先拿到空闲的缓冲区再取图像，缓冲区用完时读入自然停下 */
+            index = p->next.fetch_add(1);
+            if (index >= p->count || p->cancel) {
+                blocked = 0;
+                QueuePush(&p->queues[0], id, &blocked);
+                break;
+            }
+            slot->index  = index;
+            slot->result = FvsOK;
+        }
+        t = BatchNow();
+        if (slot->result == FvsOK && p->cancel)
+            slot->result = FvsFailure;
+        if (slot->result == FvsOK) {
+            if (s == 0)
+                slot->result = p->source(slot->index, &slot->data, p->context);
+            else
+                slot->result = PipelineExecuteStage(p->pipeline, s - 1, &slot->data);
+        }
+        t = BatchNow() - t;
+        slot->times[s] = t;
+        stage->busy += t;
+        stage->items++;
+        blocked = 0;
+        if (last) {
+            p->sink(slot->index, slot->result, &slot->data, &slot->times[0], p->context);
+            QueuePush(&p->queues[0], id, &blocked);
+        }
+        else {
+            QueuePush(&p->queues[s + 1], id, &blocked);
+            stage->blocked += blocked;
+        }
+    }
+    if (!last)
+        QueueProducerDone(&p->queues[s + 1]);
+}
+
+
+/******************************************************************************
+  * 功能：创建批处理对象，每级一个线程
+  * 参数：pipeline  处理流程
+  *       minutiae  每个缓冲区中细节点集合的大小
+  * 返回：失败返回空，否则返回新的批处理对象
+******************************************************************************/
+FvsBatch_t BatchCreate(const FvsPipeline_t pipeline, const FvsInt_t minutiae) {
+    iFvsBatch_t* p;
+    if (pipeline == NULL || minutiae <= 0)
+        return NULL;
+    p = new (std::nothrow) iFvsBatch_t;
+    if (p == NULL)
+        return NULL;
+    p->pipeline    = pipeline;
+    p->stages      = PipelineGetStageCount(pipeline) + 1;
+    p->minutiae    = minutiae;
+    p->queueSize   = BATCH_QUEUE_SIZE;
+    p->bufferCount = 0;
+    p->stage       = new (std::nothrow) iBatchStage_t[p->stages];
+    p->queues      = new (std::nothrow) iBatchQueue_t[p->stages];
+    p->cancel      = false;
+    p->next        = 0;
+    p->count       = 0;
+    p->source      = NULL;
+    p->sink        = NULL;
+    p->context     = NULL;
+    if (p->stage == NULL || p->queues == NULL) {
+        BatchDestroy((FvsBatch_t)p);
+        return NULL;
+    }
+    return (FvsBatch_t)p;
+}
+
+
+/******************************************************************************
+  * 功能：销毁批处理对象，不能在运行时调用
+  * 参数：batch  批处理对象
+  * 返回：无
+******************************************************************************/
+void BatchDestroy(FvsBatch_t batch) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    size_t i;
+    if (p == NULL)
+        return;
+    for (i = 0; i < p->slots.size(); i++)
+        BatchDestroySlot(p->slots[i]);
+    delete[] p->stage;
+    delete[] p->queues;
+    delete p;
+}
+
+
+/******************************************************************************
+  * 功能：获得级数，即流程的阶段数加1
+  * 参数：batch  批处理对象
+  * 返回：级数
+******************************************************************************/
+FvsInt_t BatchGetStageCount(const FvsBatch_t batch) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p == NULL)
+        return 0;
+    return p->stages;
+}
+
+
+/******************************************************************************
+  * 功能：获得某一级的名字，第0级为 "load"
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  * 返回：名字，序号无效时返回空
+******************************************************************************/
+const char* BatchGetStageName(const FvsBatch_t batch, const FvsInt_t stage) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p == NULL || stage < 0 || stage >= p->stages)
+        return NULL;
+    if (stage == 0)
+        return "load";
+    return PipelineGetStageName(p->pipeline, stage - 1);
+}
+
+
+/******************************************************************************
+  * 功能：设置某一级的线程数，下次运行时生效
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  *       count  线程数，至少为1
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetThreads(FvsBatch_t batch, const FvsInt_t stage, const FvsInt_t count) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p == NULL)
+        return FvsMemory;
+    if (stage < 0 || stage >= p->stages || count < 1)
+        return FvsBadParameter;
+    p->stage[stage].threads = count;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：按上次运行时各级每幅图像的处理时间分配线程
+  * 参数：batch  批处理对象
+  *       total  线程总数，小于等于0表示 ParallelGetThreadCount() 加上级数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchBalance(FvsBatch_t batch, const FvsInt_t total) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    std::vector<FvsFloat_t> cost;
+    FvsInt_t s, best, left;
+    bool measured = true;
+    if (p == NULL)
+        return FvsMemory;
+    left = (total > 0) ? total : ParallelGetThreadCount() + p->stages;
+    cost.assign((size_t)p->stages, 1.0);
+    for (s = 0; s < p->stages; s++)
+        if (p->stage[s].items == 0)
+            measured = false;
+    for (s = 0; s < p->stages; s++) {
+        if (measured)
+            cost[s] = (FvsFloat_t)p->stage[s].busy / p->stage[s].items;
+        p->stage[s].threads = 1;
+        left--;
+    }
+    /* 每次把一个线程给每线程负担最重的一级 */
+    for (; left > 0; left--) {
+        best = 0;
+        for (s = 1; s < p->stages; s++)
+            if (cost[s] / p->stage[s].threads > cost[best] / p->stage[best].threads)
+                best = s;
+        p->stage[best].threads++;
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：设置相邻两级之间队列的容量，下次运行时生效
+  * 参数：batch  批处理对象
+  *       size   容量，至少为1
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetQueueSize(FvsBatch_t batch, const FvsInt_t size) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p == NULL)
+        return FvsMemory;
+    if (size < 1)
+        return FvsBadParameter;
+    p->queueSize = size;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：设置缓冲区个数，即最多同时处理的图像数，下次运行时生效
+  * 参数：batch  批处理对象
+  *       count  缓冲区个数，小于等于0时为线程总数加级数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetBufferCount(FvsBatch_t batch, const FvsInt_t count) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p == NULL)
+        return FvsMemory;
+    p->bufferCount = (count > 0) ? count : 0;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：处理 0..count-1 幅图像，所有图像都交给 sink 之后返回
+  * 参数：batch    批处理对象
+  *       count    图像数
+  *       source   读入图像
+  *       sink     接收结果
+  *       context  传给 source 和 sink 的参数
+  * 返回：错误编号，被取消时返回 FvsFailure
+******************************************************************************/
+FvsError_t BatchRun(FvsBatch_t batch, const FvsInt_t count, FvsBatchSource_t source,
+                    FvsBatchSink_t sink, FvsPointer_t context) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    std::vector<std::thread> threads;
+    FvsInt_t s, i, buffers;
+    iBatchSlot_t* slot;
+    if (p == NULL)
+        return FvsMemory;
+    if (count < 0 || source == NULL || sink == NULL)
+        return FvsBadParameter;
+    buffers = p->bufferCount;
+    if (buffers <= 0) {
+        buffers = p->stages;
+        for (s = 0; s < p->stages; s++)
+            buffers += p->stage[s].threads;
+    }
+    /* 缓冲区在多次运行之间保留 */
+    while ((FvsInt_t)p->slots.size() < buffers) {
+        slot = BatchCreateSlot(p->stages, p->minutiae);
+        if (slot == NULL)
+            return FvsMemory;
+        p->slots.push_back(slot);
+    }
+    QueueReset(&p->queues[0], buffers, 1);
+    for (i = 0; i < buffers; i++)
+        p->queues[0].ring[i] = i;
+    p->queues[0].count = buffers;
+    for (s = 0; s < p->stages; s++) {
+        if (s > 0)
+            QueueReset(&p->queues[s], p->queueSize, p->stage[s - 1].threads);
+        p->stage[s].items   = 0;
+        p->stage[s].busy    = 0;
+        p->stage[s].starved = 0;
+        p->stage[s].blocked = 0;
+    }
+    p->cancel  = false;
+    p->next    = 0;
+    p->count   = count;
+    p->source  = source;
+    p->sink    = sink;
+    p->context = context;
+    for (s = 0; s < p->stages; s++)
+        for (i = 0; i < p->stage[s].threads; i++)
+            threads.push_back(std::thread(BatchWorker, p, s));
+    for (i = 0; i < (FvsInt_t)threads.size(); i++)
+        threads[i].join();
+    return p->cancel ? FvsFailure : FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：取消正在进行的运行，可以在任何线程中调用
+  * 参数：batch  批处理对象
+  * 返回：无
+******************************************************************************/
+void BatchCancel(FvsBatch_t batch) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    if (p != NULL)
+        p->cancel = true;
+}
+
+
+/******************************************************************************
+  * 功能：读取某一级的统计，运行期间也可以调用
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  *       stats  保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchGetStageStats(const FvsBatch_t batch, const FvsInt_t stage,
+                              FvsBatchStats_t* stats) {
+    iFvsBatch_t* p = (iFvsBatch_t*)batch;
+    iBatchQueue_t* q;
+    if (p == NULL)
+        return FvsMemory;
+    if (stats == NULL || stage < 0 || stage >= p->stages)
+        return FvsBadParameter;
+    q = &p->queues[stage];
+    stats->items   = p->stage[stage].items;
+    stats->busy    = p->stage[stage].busy;
+    stats->starved = p->stage[stage].starved;
+    stats->blocked = p->stage[stage].blocked;
+    stats->threads = p->stage[stage].threads;
+    {
+        std::lock_guard<std::mutex> guard(q->lock);
+        stats->depth     = q->count;
+        stats->maxDepth  = q->maxDepth;
+        stats->meanDepth = (q->samples > 0) ? (FvsFloat_t)q->depthSum / q->samples : 0.0;
+    }
+    return FvsOK;
+}
@@ -0,0 +1,181 @@
+/*#############################################################################
+ * 文件名：batch.h
+ * 功能：  多幅图像的流水线处理，各阶段在自己的线程中同时处理不同的图像
+#############################################################################*/
+
+#if !defined FVS__BATCH_HEADER__INCLUDED__
+#define FVS__BATCH_HEADER__INCLUDED__
+
+#include "pipeline.h"
+
+
+/******************************************************************************
+** 批处理把一个流程（pipeline.h）拆成流水线：第0级读入图像，第1..n级是流程
+** 的各个阶段。每一级有自己的若干个线程，相邻两级之间是有界的队列，
+** 所以第 N 幅图像细化时，第 N+1 幅可以在增强，第 N+2 幅在读入。
+**
+** 在各级之间传递的是预先创建的数据缓冲区（FvsPipelineData_t），处理完
+** 的缓冲区回到空闲队列中重复使用，运行期间不再申请内存。
+** 某一级的输出队列满时它等待下一级（反压），缓冲区用完时读入等待，
+** 所以同时处理的图像数不超过缓冲区个数。
+**
+** 每一级统计处理时间、等待输入和等待输出的时间以及输入队列的深度，
+** 据此可以用 BatchBalance 或 BatchSetThreads 调整各级的线程数。
+** 各阶段内部的 ParallelFor 与其它级的循环共用 parallel.h 的工作线程，
+** 不会产生更多线程；空闲的工作线程帮助最慢的一级完成它的循环。
+**
+** 流程在批处理对象存在期间不能改变。
+******************************************************************************/
+
+/* 对象的这些接口实现是私有的，不必为用户所知 */
+typedef FvsHandle_t FvsBatch_t;
+
+
+/* 一级的统计结果，第0级的输入队列是空闲的缓冲区 */
+typedef struct FvsBatchStats_t
+{
+    FvsUint64_t   items;          /* 处理的图像数                 */
+    FvsUint64_t   busy;           /* 处理时间，各线程之和，纳秒   */
+    FvsUint64_t   starved;        /* 等待输入的时间，纳秒         */
+    FvsUint64_t   blocked;        /* 输出队列满时等待的时间，纳秒 */
+    FvsInt_t      threads;        /* 线程数                       */
+    FvsInt_t      depth;          /* 输入队列当前的深度           */
+    FvsInt_t      maxDepth;       /* 输入队列最大的深度           */
+    FvsFloat_t    meanDepth;      /* 每次入队时的平均深度         */
+} FvsBatchStats_t;
+
+
+/******************************************************************************
+  * 功能：读入第 index 幅图像，在第0级的线程中调用
+  * 参数：index    图像的序号
+  *       data     缓冲区，图像读入 data->image
+  *       context  调用者的参数
+  * 返回：错误编号，出错时这幅图像不再处理，直接交给 FvsBatchSink_t
+******************************************************************************/
+typedef FvsError_t (*FvsBatchSource_t)(const FvsInt_t index, FvsPipelineData_t* data,
+			FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：一幅图像处理完后调用，在最后一级的线程中调用，
+  *       最后一级有多个线程时可能同时被调用
+  * 参数：index    图像的序号
+  *       result   错误编号，取消时为 FvsFailure
+  *       data     缓冲区，返回后会被重复使用
+  *       times    这幅图像在各级的处理时间，纳秒，BatchGetStageCount 个
+  *       context  调用者的参数
+  * 返回：无
+******************************************************************************/
+typedef void (*FvsBatchSink_t)(const FvsInt_t index, const FvsError_t result,
+			FvsPipelineData_t* data, const FvsUint64_t* times, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：创建批处理对象，每级一个线程
+  * 参数：pipeline  处理流程
+  *       minutiae  每个缓冲区中细节点集合的大小
+  * 返回：失败返回空，否则返回新的批处理对象
+******************************************************************************/
+FvsBatch_t BatchCreate(const FvsPipeline_t pipeline, const FvsInt_t minutiae);
+
+
+/******************************************************************************
+  * 功能：销毁批处理对象，不能在运行时调用
+  * 参数：batch  批处理对象
+  * 返回：无
+******************************************************************************/
+void BatchDestroy(FvsBatch_t batch);
+
+
+/******************************************************************************
+  * 功能：获得级数，即流程的阶段数加1
+  * 参数：batch  批处理对象
+  * 返回：级数
+******************************************************************************/
+FvsInt_t BatchGetStageCount(const FvsBatch_t batch);
+
+
+/******************************************************************************
+  * 功能：获得某一级的名字，第0级为 "load"
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  * 返回：名字，序号无效时返回空
+******************************************************************************/
+const char* BatchGetStageName(const FvsBatch_t batch, const FvsInt_t stage);
+
+
+/******************************************************************************
+  * 功能：设置某一级的线程数，下次运行时生效
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  *       count  线程数，至少为1
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetThreads(FvsBatch_t batch, const FvsInt_t stage, const FvsInt_t count);
+
+
+/******************************************************************************
+  * 功能：按上次运行时各级每幅图像的处理时间分配线程，每级至少一个，
+  *       其余的依次分给每线程负担最重的一级。没有运行过时平均分配。
+  * 参数：batch  批处理对象
+  *       total  线程总数，小于等于0表示 ParallelGetThreadCount() 加上级数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchBalance(FvsBatch_t batch, const FvsInt_t total);
+
+
+/******************************************************************************
+  * 功能：设置相邻两级之间队列的容量，下次运行时生效
+  * 参数：batch  批处理对象
+  *       size   容量，至少为1，缺省为2
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetQueueSize(FvsBatch_t batch, const FvsInt_t size);
+
+
+/******************************************************************************
+  * 功能：设置缓冲区个数，即最多同时处理的图像数，下次运行时生效
+  * 参数：batch  批处理对象
+  *       count  缓冲区个数，小于等于0时为线程总数加级数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchSetBufferCount(FvsBatch_t batch, const FvsInt_t count);
+
+
+/******************************************************************************
+  * 功能：处理 0..count-1 幅图像，所有图像都交给 sink 之后返回。
+  *       统计数据在开始时清零。
+  * 参数：batch    批处理对象
+  *       count    图像数
+  *       source   读入图像
+  *       sink     接收结果
+  *       context  传给 source 和 sink 的参数
+  * 返回：错误编号，被取消时返回 FvsFailure，
+  *       单幅图像的错误只通过 sink 报告
+******************************************************************************/
+FvsError_t BatchRun(FvsBatch_t batch, const FvsInt_t count, FvsBatchSource_t source,
+			FvsBatchSink_t sink, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：取消正在进行的运行，可以在任何线程中调用。
+  *       正在处理的阶段做完后，已读入的图像以 FvsFailure 交给 sink，
+  *       尚未读入的图像不再读入，也不交给 sink。
+  * 参数：batch  批处理对象
+  * 返回：无
+******************************************************************************/
+void BatchCancel(FvsBatch_t batch);
+
+
+/******************************************************************************
+  * 功能：读取某一级的统计，运行期间也可以调用
+  * 参数：batch  批处理对象
+  *       stage  级的序号
+  *       stats  保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BatchGetStageStats(const FvsBatch_t batch, const FvsInt_t stage,
+			FvsBatchStats_t* stats);
+
+
+#endif /* FVS__BATCH_HEADER__INCLUDED__ */
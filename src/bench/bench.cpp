@@ -0,0 +1,751 @@
+/*#############################################################################
+ * 文件名：bench.cpp
+ * 功能：  图像处理各个算法的性能测试
+ *         用合成的指纹图像单独测试每个算法，输出每像素耗时和内存申请次数
+#############################################################################*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "fvs.h"
+
+
+/******************************************************************************
+** 内存申请计数
+** 链接时使用 -Wl,--wrap=malloc 等，库中的申请都先经过 __wrap_xxx。
+** 编译器会把 malloc+memset 优化为 calloc，所以 calloc 也要统计。
+** 其它平台上不统计，输出为 -。
+** 工作线程和批处理的各级线程也会申请内存，所以计数器是原子的。
+******************************************************************************/
+static std::atomic<FvsUint64_t> s_allocs(0);
+
+#if defined FVS_BENCH_WRAP_MALLOC
+extern "C" void* __real_malloc(size_t size);
+extern "C" void* __real_calloc(size_t count, size_t size);
+extern "C" void* __real_realloc(void* ptr, size_t size);
+
+extern "C" void* __wrap_malloc(size_t size) {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+extern "C" void* __wrap_calloc(size_t count, size_t size) {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+extern "C" void* __wrap_realloc(void* ptr, size_t size) {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __real_realloc(ptr, size);
+}
+#endif
+
+
+/* 测试时各算法共用的数据，都由合成图像计算得到 */
+typedef struct BenchData_t {
+    FvsImage_t       source;       /* 合成的原始图像         */
+    FvsImage_t       normalized;   /* 软化、归一化之后       */
+    FvsImage_t       binarized;    /* 增强、二值化之后       */
+    FvsImage_t       thinned;      /* 细化之后               */
+    FvsImage_t       mask;
+    FvsFloatField_t  direction;
+    FvsFloatField_t  frequency;
+    FvsFieldFloat_t* theta;        /* 低通滤波前的角度       */
+    FvsMinutiaSet_t  minutia1;
+    FvsMinutiaSet_t  minutia2;     /* 平移后图像的细节点     */
+    /* 每次测试前从上面复制的工作数据 */
+    FvsImage_t       image;
+    FvsFloatField_t  field;
+    FvsFloatField_t  field2;       /* 同时输出两个域时使用   */
+    FvsImage_t       image2;       /* 同时输出两个图像时使用 */
+    FvsMinutiaSet_t  minutia;
+    FvsBitImage_t    bits;
+    FvsBitImage_t    thinbits;     /* 细化后图像的1位表示    */
+    FvsInt_t         goodness;
+} BenchData_t;
+
+
+typedef void (*BenchFunc_t)(BenchData_t* data);
+
+
+/* 一个测试项：prepare 不计时，run 计时 */
+typedef struct BenchKernel_t {
+    const char*  name;
+    BenchFunc_t  prepare;
+    BenchFunc_t  run;
+} BenchKernel_t;
+
+
+/******************************************************************************
+  * 功能：生成合成的指纹图像
+  *       以 (cx,cy) 为中心的椭圆环状脊线，加上角度相关的扭曲和一个相位奇异点
+  *       （产生分叉和端点），再加上少量噪声。
+  * 参数：image    输出图像，需已设置大小
+  *       period   脊线周期（像素）
+  *       dx, dy   中心的偏移，用于生成可以匹配的第二幅图像
+  * 返回：无
+******************************************************************************/
+static void BenchSynthesize(FvsImage_t image, const FvsFloat_t period,
+                            const FvsInt_t dx, const FvsInt_t dy) {
+    FvsByte_t* p   = ImageGetBuffer(image);
+    FvsInt_t w     = ImageGetWidth (image);
+    FvsInt_t h     = ImageGetHeight(image);
+    FvsInt_t pitch = ImageGetPitch (image);
+    FvsFloat_t cx  = w * 0.5 + dx;
+    FvsFloat_t cy  = h * 0.55 + dy;
+    FvsFloat_t sx  = w * 0.3 + dx;
+    FvsFloat_t sy  = h * 0.3 + dy;
+    FvsFloat_t u, v, r, a, phase, g;
+    FvsUint_t seed = 12345;
+    FvsInt_t x, y;
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++) {
+            u = x - cx;
+            v = (y - cy) * 1.25;
+            r = sqrt(u * u + v * v);
+            a = atan2(v, u);
+            /* 环状脊线 + 扭曲 */
+            phase = 2.0 * M_PI * r / period + 1.5 * sin(2.0 * a + r / (4.0 * period));
+            /* 相位奇异点：两条脊线在此处开始 */
+            phase += 2.0 * atan2(y - sy, x - sx);
+            seed = seed * 1103515245u + 12345u;
+            g = 128.0 + 90.0 * cos(phase) + (FvsInt_t)((seed >> 16) % 41) - 20;
+            if (g < 0.0)   g = 0.0;
+            if (g > 255.0) g = 255.0;
+            p[x + y * pitch] = (FvsByte_t)g;
+        }
+}
+
+
+/******************************************************************************
+  * 功能：按处理流程计算各算法的输入数据
+  * 参数：data    测试数据，保存方向、频率和掩码
+  *       image   合成的图像
+  *       set     输出的细节点
+  *       keep    是否保存中间结果（归一化、二值化和细化后的图像）
+  * 返回：错误编号
+******************************************************************************/
+static FvsError_t BenchPipeline(BenchData_t* data, const FvsImage_t image,
+                                FvsMinutiaSet_t set, FvsBool_t keep) {
+    FvsError_t nRet;
+    FvsImage_t work = ImageCreate();
+    if (work == NULL)
+        return FvsMemory;
+    nRet = ImageCopy(work, image);
+    if (nRet == FvsOK) nRet = ImageSoftenMean(work, 3);
+    if (nRet == FvsOK) nRet = ImageNormalize(work, 100, 10000);
+    if (nRet == FvsOK && keep == FvsTrue) nRet = ImageCopy(data->normalized, work);
+    if (nRet == FvsOK) nRet = FingerprintGetDirection(work, data->direction, 7, 8);
+    if (nRet == FvsOK) nRet = FingerprintGetFrequency1(work, data->direction, data->frequency);
+    if (nRet == FvsOK) nRet = FingerprintGetMask(work, data->direction, data->frequency, data->mask);
+    if (nRet == FvsOK) nRet = ImageEnhanceGabor(work, data->direction, data->frequency, data->mask, 4.0);
+    if (nRet == FvsOK) nRet = ImageBinarize(work, (FvsByte_t)0x80);
+    if (nRet == FvsOK && keep == FvsTrue) nRet = ImageCopy(data->binarized, work);
+    if (nRet == FvsOK) nRet = ImageThinHitMiss(work);
+    if (nRet == FvsOK && keep == FvsTrue) nRet = ImageCopy(data->thinned, work);
+    if (nRet == FvsOK) nRet = MinutiaSetExtract(set, work, data->direction, data->mask);
+    ImageDestroy(work);
+    return nRet;
+}
+
+
+/******************************************************************************
+** 各测试项
+******************************************************************************/
+static void PrepareNone(BenchData_t* data) {
+    (void)data;
+}
+
+static void PrepareNormalized(BenchData_t* data) {
+    (void)ImageCopy(data->image, data->normalized);
+}
+
+static void PrepareSource(BenchData_t* data) {
+    (void)ImageCopy(data->image, data->source);
+}
+
+static void PrepareBinarized(BenchData_t* data) {
+    (void)ImageCopy(data->image, data->binarized);
+}
+
+static void PrepareThinned(BenchData_t* data) {
+    (void)ImageCopy(data->image, data->thinned);
+}
+
+static void PrepareBinarizedBits(BenchData_t* data) {
+    (void)BitImageFromImage(data->bits, data->binarized);
+}
+
+static void PrepareThinnedBits(BenchData_t* data) {
+    (void)BitImageFromImage(data->bits, data->thinned);
+}
+
+static void RunSoften(BenchData_t* data) {
+    (void)ImageSoftenMean(data->image, 3);
+}
+
+static void RunNormalize(BenchData_t* data) {
+    (void)ImageNormalize(data->image, 100, 10000);
+}
+
+static void RunHistogram(BenchData_t* data) {
+    FvsHistogram_t histogram = HistogramCreate();
+    (void)HistogramCompute(histogram, data->normalized);
+    HistogramDestroy(histogram);
+}
+
+static void RunHistogramParallel(BenchData_t* data) {
+    FvsHistogram_t histogram = HistogramCreate();
+    (void)HistogramComputeParallel(histogram, data->normalized, NULL);
+    HistogramDestroy(histogram);
+}
+
+static void RunNormalizeMasked(BenchData_t* data) {
+    (void)ImageNormalizeMasked(data->image, data->mask, 100, 10000);
+}
+
+static void RunNormalizeLocal(BenchData_t* data) {
+    (void)ImageNormalizeLocal(data->image, 16, 100, 10000);
+}
+
+static void RunSoftenNormalize(BenchData_t* data) {
+    (void)ImageSoftenNormalize(data->image, 3, 100, 10000);
+}
+
+static void RunDirection(BenchData_t* data) {
+    (void)FingerprintGetDirection(data->normalized, data->field, 7, 8);
+}
+
+static void RunLowPass(BenchData_t* data) {
+    (void)FingerprintDirectionLowPass(data->theta, FloatFieldGetBuffer(data->field), 8,
+                                      ImageGetWidth(data->source), ImageGetHeight(data->source));
+}
+
+static void RunFrequency(BenchData_t* data) {
+    (void)FingerprintGetFrequency(data->normalized, data->direction, data->field);
+}
+
+static void RunFrequency1(BenchData_t* data) {
+    (void)FingerprintGetFrequency1(data->normalized, data->direction, data->field);
+}
+
+static void RunFrequency2(BenchData_t* data) {
+    (void)FingerprintGetFrequency2(data->normalized, data->direction, data->field);
+}
+
+static void RunFrequencyBlock(BenchData_t* data) {
+    (void)FingerprintGetFrequencyBlock(data->normalized, data->direction, data->field);
+}
+
+static void RunSpectral(BenchData_t* data) {
+    (void)FingerprintAnalyzeSpectral(data->normalized, data->field, data->field2,
+                                     data->image, NULL);
+}
+
+static void RunEnhanceChain(BenchData_t* data) {
+    (void)FingerprintGetDirection(data->image, data->field, 7, 8);
+    (void)FingerprintGetFrequency1(data->image, data->field, data->field2);
+    (void)FingerprintGetMask(data->image, data->field, data->field2, data->image2);
+    (void)ImageEnhanceGabor(data->image, data->field, data->field2, data->image2, 4.0);
+}
+
+static void RunEnhanceTiled(BenchData_t* data) {
+    (void)FingerprintEnhanceTiled(data->image, data->field, data->field2,
+                                  data->image2, 4.0, 256, NULL, NULL);
+}
+
+static void RunOrientationQuantize(BenchData_t* data) {
+    (void)OrientationFromField(data->image, data->direction);
+}
+
+static void RunMask(BenchData_t* data) {
+    (void)FingerprintGetMask(data->normalized, data->direction, data->frequency, data->image);
+}
+
+static void RunGaborFull(BenchData_t* data) {
+    (void)ImageEnhanceGaborFilter(data->image, data->direction, data->frequency,
+                                  data->mask, 4.0, FvsGaborFull);
+}
+
+static void RunGaborAdaptive(BenchData_t* data) {
+    (void)ImageEnhanceGaborFilter(data->image, data->direction, data->frequency,
+                                  data->mask, 4.0, FvsGaborAdaptive);
+}
+
+static void RunGaborTable(BenchData_t* data) {
+    (void)ImageEnhanceGaborFilter(data->image, data->direction, data->frequency,
+                                  data->mask, 4.0, FvsGaborTable);
+}
+
+static void RunGaborBinarize(BenchData_t* data) {
+    (void)ImageEnhanceGaborBinarize(data->image, data->direction, data->frequency,
+                                    data->mask, 4.0, (FvsByte_t)0x80, NULL);
+}
+
+static void RunGaborBinarizeBits(BenchData_t* data) {
+    (void)ImageEnhanceGaborBinarize(data->image, data->direction, data->frequency,
+                                    data->mask, 4.0, (FvsByte_t)0x80, data->bits);
+}
+
+static void RunBinarize(BenchData_t* data) {
+    (void)ImageBinarize(data->image, (FvsByte_t)0x80);
+}
+
+static void RunThinConnectivity(BenchData_t* data) {
+    (void)ImageThinConnectivity(data->image);
+}
+
+static void RunThinHitMiss(BenchData_t* data) {
+    (void)ImageThinHitMiss(data->image);
+}
+
+static void RunSpurs(BenchData_t* data) {
+    (void)ImageRemoveSpurs(data->image);
+}
+
+static void RunThinConnectivityTable(BenchData_t* data) {
+    (void)ImageThinTable(data->image, FvsThinConnectivity);
+}
+
+static void RunThinHitMissTable(BenchData_t* data) {
+    (void)ImageThinTable(data->image, FvsThinHitMiss);
+}
+
+static void RunThinConnectivityList(BenchData_t* data) {
+    (void)ImageThinWorkList(data->image, FvsThinConnectivity);
+}
+
+static void RunThinHitMissList(BenchData_t* data) {
+    (void)ImageThinWorkList(data->image, FvsThinHitMiss);
+}
+
+static void RunThinConnectivityParallel(BenchData_t* data) {
+    (void)ImageThinConnectivityParallel(data->image);
+}
+
+static void RunThinConnectivityBits(BenchData_t* data) {
+    (void)BitImageThinConnectivity(data->bits);
+}
+
+static void RunThinHitMissBits(BenchData_t* data) {
+    (void)BitImageThinHitMiss(data->bits);
+}
+
+static void RunSpursBits(BenchData_t* data) {
+    (void)BitImageRemoveSpurs(data->bits);
+}
+
+static void RunMinutiaBits(BenchData_t* data) {
+    (void)MinutiaSetExtractBits(data->minutia, data->thinbits, data->direction, data->mask);
+}
+
+static void RunMinutia(BenchData_t* data) {
+    (void)MinutiaSetExtract(data->minutia, data->thinned, data->direction, data->mask);
+}
+
+static void RunMatching(BenchData_t* data) {
+    (void)MatchingCompareMinutiaSets(data->minutia1, data->minutia2, &data->goodness);
+}
+
+
+static const BenchKernel_t s_kernels[] = {
+    { "soften",            PrepareSource,     RunSoften           },
+    { "normalize",         PrepareSource,     RunNormalize        },
+    { "soften-normalize",  PrepareSource,     RunSoftenNormalize  },
+    { "normalize-masked",  PrepareSource,     RunNormalizeMasked  },
+    { "normalize-local",   PrepareSource,     RunNormalizeLocal   },
+    { "histogram",         PrepareNone,       RunHistogram        },
+    { "histogram-parallel", PrepareNone,      RunHistogramParallel },
+    { "direction",         PrepareNone,       RunDirection        },
+    { "lowpass",           PrepareNone,       RunLowPass          },
+    { "frequency",         PrepareNone,       RunFrequency        },
+    { "frequency1",        PrepareNone,       RunFrequency1       },
+    { "frequency2",        PrepareNone,       RunFrequency2       },
+    { "frequency-block",   PrepareNone,       RunFrequencyBlock   },
+    { "spectral",          PrepareNone,       RunSpectral         },
+    { "orientation-quantize", PrepareNone,    RunOrientationQuantize },
+    { "mask",              PrepareNone,       RunMask             },
+    { "gabor-full",        PrepareNormalized, RunGaborFull        },
+    { "gabor-adaptive",    PrepareNormalized, RunGaborAdaptive    },
+    { "gabor-table",       PrepareNormalized, RunGaborTable       },
+    { "gabor-binarize",    PrepareNormalized, RunGaborBinarize    },
+    { "enhance-chain",     PrepareNormalized, RunEnhanceChain     },
+    { "enhance-tiled",     PrepareNormalized, RunEnhanceTiled     },
+    { "gabor-binarize-bits", PrepareNormalized, RunGaborBinarizeBits },
+    { "binarize",          PrepareNormalized, RunBinarize         },
+    { "thin-connectivity", PrepareBinarized,  RunThinConnectivity },
+    { "thin-hitmiss",      PrepareBinarized,  RunThinHitMiss      },
+    { "spurs",             PrepareThinned,    RunSpurs            },
+    { "thin-conn-table",   PrepareBinarized,  RunThinConnectivityTable },
+    { "thin-hitmiss-table", PrepareBinarized, RunThinHitMissTable      },
+    { "thin-conn-list",    PrepareBinarized,  RunThinConnectivityList },
+    { "thin-hitmiss-list", PrepareBinarized,  RunThinHitMissList      },
+    { "thin-conn-parallel", PrepareBinarized, RunThinConnectivityParallel },
+    { "thin-conn-bits",    PrepareBinarizedBits, RunThinConnectivityBits },
+    { "thin-hitmiss-bits", PrepareBinarizedBits, RunThinHitMissBits      },
+    { "spurs-bits",        PrepareThinnedBits,   RunSpursBits            },
+    { "minutia",           PrepareNone,       RunMinutia          },
+    { "minutia-bits",      PrepareNone,       RunMinutiaBits      },
+    { "matching",          PrepareNone,       RunMatching         }
+};
+
+
+static FvsUint64_t BenchNow() {
+    return (FvsUint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/* 按描述组装流程，在合成图像上运行 iterations 次，输出每个阶段的耗时 */
+static FvsError_t BenchRunPipeline(BenchData_t* data, const char* description,
+                                   const FvsInt_t iterations) {
+    FvsPipeline_t pipeline = PipelineCreate();
+    FvsPipelineData_t pd;
+    FvsPipelineStats_t stats;
+    FvsUint64_t best[64], total = 0;
+    FvsInt_t w = ImageGetWidth(data->source);
+    FvsInt_t h = ImageGetHeight(data->source);
+    FvsInt_t i, n, count;
+    FvsError_t nRet = PipelineParse(pipeline, description);
+    count = PipelineGetStageCount(pipeline);
+    if (nRet == FvsOK && count > 64)
+        nRet = FvsBadParameter;
+    pd.image     = data->image;
+    pd.direction = data->field;
+    pd.frequency = data->field2;
+    pd.mask      = data->image2;
+    pd.bits      = data->bits;
+    pd.minutia   = data->minutia;
+    for (n = 0; n < iterations && nRet == FvsOK; n++) {
+        nRet = ImageCopy(data->image, data->source);
+        if (nRet == FvsOK)
+            nRet = PipelineRun(pipeline, &pd, NULL, NULL);
+        for (i = 0; i < count && nRet == FvsOK; i++) {
+            PipelineGetStageStats(pipeline, i, &stats);
+            if (n == 0 || stats.last < best[i])
+                best[i] = stats.last;
+        }
+    }
+    if (nRet != FvsOK) {
+        fprintf(stderr, "pipeline \"%s\" failed (error %d)\n", description, (int)nRet);
+        PipelineDestroy(pipeline);
+        return nRet;
+    }
+    fprintf(stderr, "%-18s %12s %12s %10s\n", "stage", "mean us", "min us", "ns/pixel");
+    for (i = 0; i < count; i++) {
+        PipelineGetStageStats(pipeline, i, &stats);
+        total += stats.nanoseconds;
+        fprintf(stderr, "%-18s %12.1f %12.1f %10.2f\n", PipelineGetStageName(pipeline, i),
+                stats.nanoseconds / 1000.0 / iterations, best[i] / 1000.0,
+                (FvsFloat_t)stats.nanoseconds / iterations / (w * h));
+    }
+    fprintf(stderr, "%-18s %12.1f %12s %10.2f, %d minutiae\n", "total",
+            total / 1000.0 / iterations, "", (FvsFloat_t)total / iterations / (w * h),
+            MinutiaSetGetCount(data->minutia));
+    PipelineDestroy(pipeline);
+    return FvsOK;
+}
+
+
+/* 批处理的读入：复制合成图像 */
+static FvsError_t BenchBatchLoad(const FvsInt_t index, FvsPipelineData_t* pd,
+                                 FvsPointer_t context) {
+    (void)index;
+    return ImageCopy(pd->image, ((BenchData_t*)context)->source);
+}
+
+
+/* 批处理的结果：只记录错误，最后一级有多个线程时会并发调用 */
+static std::atomic<int> s_batchError(FvsOK);
+
+static void BenchBatchStore(const FvsInt_t index, const FvsError_t result,
+                            FvsPipelineData_t* pd, const FvsUint64_t* times,
+                            FvsPointer_t context) {
+    (void)index;
+    (void)pd;
+    (void)times;
+    (void)context;
+    if (result != FvsOK)
+        s_batchError.store((int)result);
+}
+
+
+/* 用批处理在 images 幅合成图像上运行流程，先平均分配线程，再按计时重新分配 */
+static FvsError_t BenchRunBatch(BenchData_t* data, const char* description,
+                                const FvsInt_t images) {
+    FvsPipeline_t pipeline = PipelineCreate();
+    FvsBatch_t batch = NULL;
+    FvsBatchStats_t stats;
+    FvsUint64_t t;
+    FvsInt_t round, s;
+    FvsError_t nRet = PipelineParse(pipeline, description);
+    if (nRet == FvsOK) {
+        batch = BatchCreate(pipeline, 1000);
+        if (batch == NULL)
+            nRet = FvsMemory;
+    }
+    for (round = 0; round < 2 && nRet == FvsOK; round++) {
+        nRet = BatchBalance(batch, 0);
+        s_batchError.store(FvsOK);
+        t = BenchNow();
+        if (nRet == FvsOK)
+            nRet = BatchRun(batch, images, BenchBatchLoad, BenchBatchStore, data);
+        t = BenchNow() - t;
+        if (nRet == FvsOK)
+            nRet = (FvsError_t)s_batchError.load();
+        if (nRet != FvsOK)
+            break;
+        fprintf(stderr, "%s: %d images, %.1f ms, %.1f images/s\n",
+                round == 0 ? "even" : "balanced", images, t / 1e6, images * 1e9 / t);
+        fprintf(stderr, "%-18s %8s %12s %12s %12s %8s\n",
+                "stage", "threads", "busy us/img", "starved ms", "blocked ms", "queue");
+        for (s = 0; s < BatchGetStageCount(batch); s++) {
+            BatchGetStageStats(batch, s, &stats);
+            fprintf(stderr, "%-18s %8d %12.1f %12.1f %12.1f %5.1f/%d\n",
+                    BatchGetStageName(batch, s), stats.threads,
+                    stats.items ? stats.busy / 1000.0 / stats.items : 0.0,
+                    stats.starved / 1e6, stats.blocked / 1e6, stats.meanDepth, stats.maxDepth);
+        }
+    }
+    if (nRet != FvsOK)
+        fprintf(stderr, "batch \"%s\" failed (error %d)\n", description, (int)nRet);
+    BatchDestroy(batch);
+    PipelineDestroy(pipeline);
+    return nRet;
+}
+
+
+/* 两幅图像的大小和每个象素是否都相同 */
+static FvsBool_t BenchSameImage(const FvsImage_t a, const FvsImage_t b) {
+    FvsInt_t w = ImageGetWidth(a);
+    FvsInt_t h = ImageGetHeight(a);
+    FvsInt_t y;
+    if (w != ImageGetWidth(b) || h != ImageGetHeight(b))
+        return FvsFalse;
+    for (y = 0; y < h; y++)
+        if (memcmp(ImageGetBuffer(a) + y * ImageGetPitch(a),
+                   ImageGetBuffer(b) + y * ImageGetPitch(b), w) != 0)
+            return FvsFalse;
+    return FvsTrue;
+}
+
+
+/* 检查增强并二值化的两种输出与先增强再二值化相同，阈值包括两端 */
+static FvsError_t BenchVerify(BenchData_t* data) {
+    static const FvsInt_t limits[] = { 0, 1, 128, 255 };
+    FvsError_t nRet = FvsOK;
+    FvsBool_t same8, same1;
+    size_t l;
+    for (l = 0; l < sizeof(limits) / sizeof(limits[0]) && nRet == FvsOK; l++) {
+        nRet = ImageCopy(data->image2, data->normalized);
+        if (nRet == FvsOK)
+            nRet = ImageEnhanceGabor(data->image2, data->direction, data->frequency,
+                                     data->mask, 4.0);
+        if (nRet == FvsOK) nRet = ImageBinarize(data->image2, (FvsByte_t)limits[l]);
+        if (nRet == FvsOK) nRet = ImageCopy(data->image, data->normalized);
+        if (nRet == FvsOK)
+            nRet = ImageEnhanceGaborBinarize(data->image, data->direction, data->frequency,
+                                             data->mask, 4.0, (FvsByte_t)limits[l], NULL);
+        if (nRet != FvsOK)
+            break;
+        same8 = BenchSameImage(data->image, data->image2);
+        nRet = ImageCopy(data->image, data->normalized);
+        if (nRet == FvsOK)
+            nRet = ImageEnhanceGaborBinarize(data->image, data->direction, data->frequency,
+                                             data->mask, 4.0, (FvsByte_t)limits[l], data->bits);
+        if (nRet == FvsOK) nRet = BitImageToImage(data->image, data->bits);
+        if (nRet != FvsOK)
+            break;
+        same1 = BenchSameImage(data->image, data->image2);
+        fprintf(stderr, "gabor-binarize limit %3d: 8-bit %s, 1-bit %s\n", limits[l],
+                same8 == FvsTrue ? "same" : "DIFFERENT", same1 == FvsTrue ? "same" : "DIFFERENT");
+        if (same8 == FvsFalse || same1 == FvsFalse)
+            nRet = FvsFailure;
+    }
+    return nRet;
+}
+
+
+static void BenchUsage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [-w width] [-h height] [-n iterations] [-p period] [-t threads]\n"
+            "          [-P pipeline [-B images]] [-V] [kernel...]\n"
+            "  default 256x256, 10 iterations, ridge period 9 pixels, one thread per\n"
+            "  processor, all kernels.\n"
+            "  -P times each stage of a pipeline description (pipeline.h) instead of\n"
+            "  the kernels, e.g. -P \"soften-normalize direction frequency1 mask gabor\"\n"
+            "  -B runs the pipeline over that many images with the batch executor\n"
+            "  (batch.h), one thread pool per stage.\n"
+            "  -V checks that the fused kernels match the separate steps instead of\n"
+            "  timing anything, and exits with 1 on a mismatch.\n"
+            "  results go to stderr; the library prints its own diagnostics on stdout.\n"
+            "kernels:", name);
+    for (size_t k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++)
+        fprintf(stderr, " %s", s_kernels[k].name);
+    fprintf(stderr, "\n");
+}
+
+
+int main(int argc, char* argv[]) {
+    FvsInt_t w = 256, h = 256, iterations = 10;
+    FvsFloat_t period = 9.0;
+    FvsInt_t selected = 0;
+    const char* pipeline = NULL;
+    FvsInt_t images = 0;
+    bool verify = false;
+    FvsInt_t i, n;
+    size_t k;
+    const size_t count = sizeof(s_kernels) / sizeof(s_kernels[0]);
+    bool run[sizeof(s_kernels) / sizeof(s_kernels[0])];
+    BenchData_t data;
+    FvsImage_t shifted;
+    FvsError_t nRet = FvsOK;
+    memset(run, 0, sizeof(run));
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            w = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc)
+            h = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            period = atof(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            ParallelSetThreadCount(atoi(argv[++i]));
+        else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc)
+            pipeline = argv[++i];
+        else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc)
+            images = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-V") == 0)
+            verify = true;
+        else {
+            for (k = 0; k < count; k++)
+                if (strcmp(argv[i], s_kernels[k].name) == 0)
+                    break;
+            if (k == count) {
+                BenchUsage(argv[0]);
+                return 1;
+            }
+            run[k] = true;
+            selected++;
+        }
+    }
+    if (w < 64 || h < 64 || iterations < 1 || period < 3.0 ||
+            images < 0 || (images > 0 && pipeline == NULL)) {
+        BenchUsage(argv[0]);
+        return 1;
+    }
+    /* 准备数据 */
+    memset(&data, 0, sizeof(data));
+    data.source     = ImageCreate();
+    data.normalized = ImageCreate();
+    data.binarized  = ImageCreate();
+    data.thinned    = ImageCreate();
+    data.mask       = ImageCreate();
+    data.image      = ImageCreate();
+    data.image2     = ImageCreate();
+    data.direction  = FloatFieldCreate();
+    data.frequency  = FloatFieldCreate();
+    data.field      = FloatFieldCreate();
+    data.field2     = FloatFieldCreate();
+    data.minutia1   = MinutiaSetCreate(1000);
+    data.minutia2   = MinutiaSetCreate(1000);
+    data.minutia    = MinutiaSetCreate(1000);
+    data.bits       = BitImageCreate();
+    data.thinbits   = BitImageCreate();
+    data.theta      = (FvsFieldFloat_t*)malloc(w * h * sizeof(FvsFieldFloat_t));
+    shifted         = ImageCreate();
+    if (data.source == NULL || data.normalized == NULL || data.binarized == NULL ||
+            data.thinned == NULL || data.mask == NULL || data.image == NULL ||
+            data.image2 == NULL ||
+            data.direction == NULL || data.frequency == NULL || data.field == NULL ||
+            data.field2 == NULL ||
+            data.minutia1 == NULL || data.minutia2 == NULL || data.minutia == NULL ||
+            data.theta == NULL || shifted == NULL ||
+            data.bits == NULL || data.thinbits == NULL)
+        nRet = FvsMemory;
+    if (nRet == FvsOK) nRet = ImageSetSize(data.source, w, h);
+    if (nRet == FvsOK) nRet = ImageSetSize(shifted, w, h);
+    if (nRet == FvsOK) {
+        BenchSynthesize(data.source, period, 0, 0);
+        BenchSynthesize(shifted, period, 5, -3);
+        nRet = BenchPipeline(&data, shifted, data.minutia2, FvsFalse);
+    }
+    if (nRet == FvsOK)
+        nRet = BenchPipeline(&data, data.source, data.minutia1, FvsTrue);
+    if (nRet == FvsOK)
+        nRet = BitImageFromImage(data.thinbits, data.thinned);
+    if (nRet != FvsOK) {
+        fprintf(stderr, "failed to prepare benchmark data (error %d)\n", (int)nRet);
+        return 1;
+    }
+    /* 低通滤波的输入：2倍方向角 */
+    {
+        FvsFieldFloat_t* dir = FloatFieldGetBuffer(data.direction);
+        for (n = 0; n < w * h; n++)
+            data.theta[n] = 2.0 * dir[n];
+    }
+    fprintf(stderr, "image %dx%d, ridge period %.1f, %d iterations, %d threads, "
+            "field %d bytes, minutiae %d/%d\n",
+            w, h, period, iterations, ParallelGetThreadCount(), (int)sizeof(FvsFieldFloat_t),
+            MinutiaSetGetCount(data.minutia1), MinutiaSetGetCount(data.minutia2));
+    if (verify)
+        nRet = BenchVerify(&data);
+    else if (pipeline != NULL && images > 0)
+        nRet = BenchRunBatch(&data, pipeline, images);
+    else if (pipeline != NULL)
+        nRet = BenchRunPipeline(&data, pipeline, iterations);
+    else
+        fprintf(stderr, "%-18s %12s %12s %10s %10s\n",
+                "kernel", "mean us", "min us", "ns/pixel", "allocs");
+    for (k = 0; k < count && pipeline == NULL && !verify; k++) {
+        FvsUint64_t total = 0, best = 0, allocs = 0, t;
+        if (selected > 0 && !run[k])
+            continue;
+        for (i = 0; i < iterations; i++) {
+            s_kernels[k].prepare(&data);
+            s_allocs.store(0);
+            t = BenchNow();
+            s_kernels[k].run(&data);
+            t = BenchNow() - t;
+            allocs += s_allocs.load();
+            total  += t;
+            if (i == 0 || t < best)
+                best = t;
+        }
+#if defined FVS_BENCH_WRAP_MALLOC
+        fprintf(stderr, "%-18s %12.1f %12.1f %10.2f %10.1f\n", s_kernels[k].name,
+                total / 1000.0 / iterations, best / 1000.0,
+                (FvsFloat_t)total / iterations / (w * h),
+                (FvsFloat_t)allocs / iterations);
+#else
+        fprintf(stderr, "%-18s %12.1f %12.1f %10.2f %10s\n", s_kernels[k].name,
+                total / 1000.0 / iterations, best / 1000.0,
+                (FvsFloat_t)total / iterations / (w * h), "-");
+#endif
+    }
+    ImageDestroy(shifted);
+    ImageDestroy(data.source);
+    ImageDestroy(data.normalized);
+    ImageDestroy(data.binarized);
+    ImageDestroy(data.thinned);
+    ImageDestroy(data.mask);
+    ImageDestroy(data.image);
+    ImageDestroy(data.image2);
+    FloatFieldDestroy(data.direction);
+    FloatFieldDestroy(data.frequency);
+    FloatFieldDestroy(data.field);
+    FloatFieldDestroy(data.field2);
+    MinutiaSetDestroy(data.minutia1);
+    MinutiaSetDestroy(data.minutia2);
+    MinutiaSetDestroy(data.minutia);
+    BitImageDestroy(data.bits);
+    BitImageDestroy(data.thinbits);
+    free(data.theta);
+    return (nRet == FvsOK) ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#-------------------------------------------------
+#
+# Microbenchmarks for the image-processing kernels.
+# Build with qmake in this directory and run ./bench -help for options.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = bench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ..
+
+# count library allocations by routing them through __wrap_malloc etc.
+unix {
+    DEFINES += FVS_BENCH_WRAP_MALLOC
+    QMAKE_LFLAGS += -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+}
+
+# qmake CONFIG+=field_float32 measures the single-precision fields
+field_float32 {
+    DEFINES += FVS_FIELD_FLOAT32
+}
+
+SOURCES += bench.cpp \
+    ../batch.cpp \
+    ../bitimage.cpp \
+    ../export.cpp \
+    ../fft.cpp \
+    ../file.cpp \
+    ../floatfield.cpp \
+    ../histogram.cpp \
+    ../image.cpp \
+    ../imagemanip.cpp \
+    ../img_base.cpp \
+    ../img_enhance.cpp \
+    ../img_morphology.cpp \
+    ../img_thinning.cpp \
+    ../import.cpp \
+    ../matching.cpp \
+    ../minutia.cpp \
+    ../orientation.cpp \
+    ../parallel.cpp \
+    ../pipeline.cpp \
+    ../profile.cpp \
+    ../sampler.cpp
+
+HEADERS += ../fvs.h \
+    ../batch.h \
+    ../bitimage.h \
+    ../fft.h \
+    ../fvstypes.h \
+    ../imagemanip.h \
+    ../orientation.h \
+    ../parallel.h \
+    ../pipeline.h \
+    ../profile.h \
+    ../sampler.h
@@ -0,0 +1,532 @@
+
+/*#############################################################################
+ * 文件名：bitimage.cpp
+ * 功能：  1位二值图像，用于细化和细节点提取
+#############################################################################*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitimage.h"
+#include "profile.h"
+
+
+#define BIT_ONES    (~(FvsUint64_t)0)
+
+
+/* 1位图像结构 */
+typedef struct iFvsBitImage_t
+{
+    FvsUint64_t     *pbits;        /* 图像数组，每行 words 个字 */
+    FvsInt_t        w;             /* 宽度                      */
+    FvsInt_t        h;             /* 高度                      */
+    FvsInt_t        words;         /* 每行的字数                */
+    FvsImageFlag_t  flags;         /* 标记                      */
+} iFvsBitImage_t;
+
+
+/******************************************************************************
+  * 功能：创建一个新的1位图像对象
+  * 参数：无
+  * 返回：失败返回空，否则返回新的图像对象
+******************************************************************************/
+FvsBitImage_t BitImageCreate() {
+    iFvsBitImage_t* p = NULL;
+    p = (iFvsBitImage_t*)malloc(sizeof(iFvsBitImage_t));
+    if (p != NULL) {
+        p->pbits = NULL;
+        p->w     = 0;
+        p->h     = 0;
+        p->words = 0;
+        p->flags = FvsImageBinarized;
+    }
+    return (FvsBitImage_t)p;
+}
+
+
+/******************************************************************************
+  * 功能：销毁一个1位图像对象
+  * 参数：image  指向图像对象的指针
+  * 返回：无
+******************************************************************************/
+void BitImageDestroy(FvsBitImage_t image) {
+    iFvsBitImage_t* p = (iFvsBitImage_t*)image;
+    if (p == NULL)
+        return;
+    if (p->pbits != NULL)
+        free(p->pbits);
+    free(p);
+}
+
+
+/******************************************************************************
+  * 功能：设置1位图像的大小，内容清零
+  * 参数：image   指向图像对象的指针
+  *       width   图像宽度
+  *       height  图像高度
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageSetSize(FvsBitImage_t img, const FvsInt_t width,
+                           const FvsInt_t height) {
+    iFvsBitImage_t* image = (iFvsBitImage_t*)img;
+    FvsInt_t words = (width + 63) >> 6;
+    FvsInt_t newsize = words * height;
+    if (image == NULL || width < 0 || height < 0)
+        return FvsBadParameter;
+    if (newsize != image->words * image->h) {
+        if (image->pbits != NULL)
+            free(image->pbits);
+        image->pbits = NULL;
+        image->w = image->h = image->words = 0;
+        if (newsize == 0)
+            return FvsOK;
+        image->pbits = (FvsUint64_t*)malloc((size_t)newsize * sizeof(FvsUint64_t));
+        if (image->pbits == NULL)
+            return FvsMemory;
+    }
+    image->w     = width;
+    image->h     = height;
+    image->words = words;
+    if (newsize > 0)
+        memset(image->pbits, 0, (size_t)newsize * sizeof(FvsUint64_t));
+    return FvsOK;
+}
+
+
+FvsInt_t BitImageGetWidth(const FvsBitImage_t image) {
+    return ((iFvsBitImage_t*)image)->w;
+}
+
+
+FvsInt_t BitImageGetHeight(const FvsBitImage_t image) {
+    return ((iFvsBitImage_t*)image)->h;
+}
+
+
+FvsInt_t BitImageGetWords(const FvsBitImage_t image) {
+    return ((iFvsBitImage_t*)image)->words;
+}
+
+
+FvsUint64_t* BitImageGetBuffer(FvsBitImage_t image) {
+    return ((iFvsBitImage_t*)image)->pbits;
+}
+
+
+FvsImageFlag_t BitImageGetFlag(const FvsBitImage_t image) {
+    return ((iFvsBitImage_t*)image)->flags;
+}
+
+
+FvsError_t BitImageSetFlag(FvsBitImage_t image, const FvsImageFlag_t flag) {
+    if (image == NULL)
+        return FvsMemory;
+    ((iFvsBitImage_t*)image)->flags = flag;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：由8位图像得到1位图像，非0的象素置1，标记也一起复制
+  * 参数：bits   1位图像
+  *       image  8位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageFromImage(FvsBitImage_t bits, const FvsImage_t image) {
+    iFvsBitImage_t* b = (iFvsBitImage_t*)bits;
+    FvsByte_t* p   = ImageGetBuffer(image);
+    FvsInt_t w     = ImageGetWidth (image);
+    FvsInt_t h     = ImageGetHeight(image);
+    FvsInt_t pitch = ImageGetPitch (image);
+    FvsInt_t x, y, n, k;
+    FvsUint64_t v;
+    FvsError_t nRet;
+    if (p == NULL)
+        return FvsMemory;
+    nRet = BitImageSetSize(bits, w, h);
+    if (nRet != FvsOK)
+        return nRet;
+    for (y = 0; y < h; y++) {
+        FvsUint64_t* row = b->pbits + y * b->words;
+        const FvsByte_t* src = p + y * pitch;
+        for (k = 0, x = 0; k < b->words; k++) {
+            v = 0;
+            for (n = 0; n < 64 && x < w; n++, x++)
+                if (src[x] != 0)
+                    v |= (FvsUint64_t)1 << n;
+            row[k] = v;
+        }
+    }
+    b->flags = ImageGetFlag(image);
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：由1位图像得到8位图像，1置为0xFF，0置为0x00，标记也一起复制
+  * 参数：image  8位图像
+  *       bits   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageToImage(FvsImage_t image, const FvsBitImage_t bits) {
+    iFvsBitImage_t* b = (iFvsBitImage_t*)bits;
+    FvsByte_t* p;
+    FvsInt_t pitch;
+    FvsInt_t x, y;
+    FvsError_t nRet = ImageSetSize(image, b->w, b->h);
+    if (nRet != FvsOK)
+        return nRet;
+    p     = ImageGetBuffer(image);
+    pitch = ImageGetPitch (image);
+    if (p == NULL && b->w * b->h > 0)
+        return FvsMemory;
+    for (y = 0; y < b->h; y++) {
+        const FvsUint64_t* row = b->pbits + y * b->words;
+        FvsByte_t* dst = p + y * pitch;
+        for (x = 0; x < b->w; x++)
+            dst[x] = ((row[x >> 6] >> (x & 63)) & 1) ? 0xFF : 0x00;
+    }
+    return ImageSetFlag(image, b->flags);
+}
+
+
+/******************************************************************************
+** 邻域点与 imagemanip.cpp 中的定义相同:
+**     9 2 3
+**     8 1 4
+**     7 6 5
+** 对一个字中的64个象素同时取出它们的某个邻点：
+** 东边 (x+1) 是右移一位，高位由下一个字的最低位补上；西边 (x-1) 相反。
+******************************************************************************/
+static FvsUint64_t BitEast(const FvsUint64_t* row, const FvsInt_t k, const FvsInt_t words) {
+    FvsUint64_t v;
+    if (row == NULL)
+        return 0;
+    v = row[k] >> 1;
+    if (k + 1 < words)
+        v |= row[k + 1] << 63;
+    return v;
+}
+
+
+static FvsUint64_t BitWest(const FvsUint64_t* row, const FvsInt_t k) {
+    FvsUint64_t v;
+    if (row == NULL)
+        return 0;
+    v = row[k] << 1;
+    if (k > 0)
+        v |= row[k - 1] >> 63;
+    return v;
+}
+
+
+/* 第k个字中内部象素 (1 <= x <= w-2) 的掩码 */
+static FvsUint64_t BitInterior(const FvsInt_t k, const FvsInt_t w) {
+    FvsInt_t n = w - 1 - (k << 6);	/* 本字中 x < w-1 的位数 */
+    FvsUint64_t m = BIT_ONES;
+    if (n <= 0)
+        return 0;
+    if (n < 64)
+        m = ((FvsUint64_t)1 << n) - 1;
+    if (k == 0)
+        m &= ~(FvsUint64_t)1;
+    return m;
+}
+
+
+/* 取出 P2..P9，保存在 nb[0]..nb[7] 中 */
+static void BitNeighbours(const iFvsBitImage_t* image, const FvsInt_t y,
+                          const FvsInt_t k, FvsUint64_t nb[8]) {
+    const FvsUint64_t* c = image->pbits + y * image->words;
+    const FvsUint64_t* n = (y > 0) ? c - image->words : NULL;
+    const FvsUint64_t* s = (y < image->h - 1) ? c + image->words : NULL;
+    FvsInt_t words = image->words;
+    nb[0] = (n != NULL) ? n[k] : 0;		/* P2 */
+    nb[1] = BitEast(n, k, words);		/* P3 */
+    nb[2] = BitEast(c, k, words);		/* P4 */
+    nb[3] = BitEast(s, k, words);		/* P5 */
+    nb[4] = (s != NULL) ? s[k] : 0;		/* P6 */
+    nb[5] = BitWest(s, k);				/* P7 */
+    nb[6] = BitWest(c, k);				/* P8 */
+    nb[7] = BitWest(n, k);				/* P9 */
+}
+
+
+/* 按位分片的加法：统计 nb[0..7] 中每一位上1的个数 */
+static void BitCount(const FvsUint64_t nb[8], FvsUint64_t s[4]) {
+    FvsUint64_t c0, c1, c2;
+    FvsInt_t i;
+    s[0] = s[1] = s[2] = s[3] = 0;
+    for (i = 0; i < 8; i++) {
+        c0 = s[0] & nb[i];
+        s[0] ^= nb[i];
+        c1 = s[1] & c0;
+        s[1] ^= c0;
+        c2 = s[2] & c1;
+        s[2] ^= c1;
+        s[3] |= c2;
+    }
+}
+
+
+/* 每一位上，t[0..n-1] 中恰好有一个为1 */
+static FvsUint64_t BitExactlyOne(const FvsUint64_t* t, const FvsInt_t n) {
+    FvsUint64_t one = 0, two = 0;
+    FvsInt_t i;
+    for (i = 0; i < n; i++) {
+        two |= one & t[i];
+        one |= t[i];
+    }
+    return one & ~two;
+}
+
+
+void BitImageNeighbourCount(const FvsBitImage_t image, const FvsInt_t y,
+                            const FvsInt_t k, FvsUint64_t count[4]) {
+    FvsUint64_t nb[8];
+    BitNeighbours((const iFvsBitImage_t*)image, y, k, nb);
+    BitCount(nb, count);
+}
+
+
+/******************************************************************************
+  * 功能：细化的一个子迭代，先对所有象素判断，再统一删除，
+  *       与 ImageThinConnectivity 中的 0x80 标记等价
+  * 参数：image   1位图像
+  *       del     2行的删除标记缓冲区
+  *       step    0 为第一个子迭代，1 为第二个
+  * 返回：是否有象素被删除
+******************************************************************************/
+static FvsBool_t BitThinStep(iFvsBitImage_t* image, FvsUint64_t* del, const FvsInt_t step) {
+    FvsInt_t words = image->words;
+    FvsInt_t x, y, k;
+    FvsUint64_t nb[8], s[4], t[8];
+    FvsUint64_t c, a, b, d;
+    FvsUint64_t *cur, *prev;
+    FvsBool_t changed = FvsFalse;
+    for (y = 1; y < image->h - 1; y++) {
+        cur = del + (y & 1) * words;
+        for (k = 0; k < words; k++) {
+            c = image->pbits[y * words + k] & BitInterior(k, image->w);
+            if (c == 0) {
+                cur[k] = 0;
+                continue;
+            }
+            BitNeighbours(image, y, k, nb);
+            /* a) 有2-6个邻点：个数不是0,1和7,8 */
+            BitCount(nb, s);
+            a = (s[1] | s[2]) & ~(s[0] & s[1] & s[2]);
+            /* b) 按 9,2,3,...,8,9 的顺序由0变1的次数为1 */
+            for (x = 0; x < 8; x++)
+                t[x] = ~nb[(x + 7) & 7] & nb[x];
+            b = BitExactlyOne(t, 8);
+            /* c), d) */
+            if (step == 0)
+                d = ~(nb[0] & nb[2] & nb[4]) & ~(nb[2] & nb[4] & nb[6]);
+            else
+                d = ~(nb[0] & nb[4] & nb[6]) & ~(nb[0] & nb[2] & nb[6]);
+            cur[k] = c & a & b & d;
+            if (cur[k] != 0)
+                changed = FvsTrue;
+        }
+        /* 上一行已不再被读取，可以删除了 */
+        if (y > 1) {
+            prev = del + ((y - 1) & 1) * words;
+            for (k = 0; k < words; k++)
+                image->pbits[(y - 1) * words + k] &= ~prev[k];
+        }
+    }
+    if (image->h > 2) {
+        y = image->h - 2;
+        cur = del + (y & 1) * words;
+        for (k = 0; k < words; k++)
+            image->pbits[y * words + k] &= ~cur[k];
+    }
+    return changed;
+}
+
+
+/******************************************************************************
+  * 功能：细化1位图像，与 ImageThinConnectivity 结果相同
+  *       图像必须是二值化过的
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageThinConnectivity(FvsBitImage_t img) {
+    iFvsBitImage_t* image = (iFvsBitImage_t*)img;
+    FvsUint64_t* del;
+    FvsInt_t passes = 0;
+    FvsBool_t changed = FvsTrue;
+    FVS_PROFILE_BEGIN(tprof);
+    if (image->pbits == NULL)
+        return FvsMemory;
+    if (image->flags != FvsImageBinarized)
+        return FvsBadParameter;
+    del = (FvsUint64_t*)malloc(2 * image->words * sizeof(FvsUint64_t));
+    if (del == NULL)
+        return FvsMemory;
+    while (changed == FvsTrue) {
+        passes++;
+        changed = BitThinStep(image, del, 0);
+        if (BitThinStep(image, del, 1) == FvsTrue)
+            changed = FvsTrue;
+    }
+    free(del);
+    (void)BitImageRemoveSpurs(img);
+    image->flags = FvsImageThinned;
+    FVS_PROFILE_END(tprof, FvsProfileThinning, image->w * image->h, passes, 0);
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：Hit and Miss 细化的一遍扫描。
+  *       逐字节实现按光栅顺序立即删除，所以某点的判断用到的左邻点（以及上一行）
+  *       是已更新的值，右邻点和下一行是原值。上一行整行处理完后才处理本行，
+  *       所以只有左邻点的依赖在一个字之内。
+  *       对每一位分别算出左邻点为0时的结果 a 和为1时的结果 b，
+  *       再迭代 F = C & ~(左邻点 ? b : a) 直到不变，即为按顺序处理的结果。
+  * 参数：image   1位图像
+  * 返回：是否有象素被删除
+******************************************************************************/
+static FvsBool_t BitHitMissPass(iFvsBitImage_t* image) {
+    FvsInt_t words = image->words;
+    FvsInt_t y, k;
+    FvsUint64_t nb[8];
+    FvsUint64_t c, in, a, b, r, f, fn, l, carry;
+    FvsUint64_t *row;
+    FvsBool_t changed = FvsFalse;
+    for (y = 1; y < image->h - 1; y++) {
+        row = image->pbits + y * words;
+        for (k = 0; k < words; k++) {
+            c  = row[k];
+            in = c & BitInterior(k, image->w);
+            if (in == 0)
+                continue;
+            BitNeighbours(image, y, k, nb);
+#define N   nb[0]
+#define NE  nb[1]
+#define E   nb[2]
+#define SE  nb[3]
+#define S   nb[4]
+#define SW  nb[5]
+#define NW  nb[7]
+            /* 与左邻点无关的两个模板 */
+            r  = (~NW & ~N & ~NE & SW & S & SE) | (NW & N & NE & ~SW & ~S & ~SE);
+            /* 左邻点为0 */
+            a  = r | (~NW & ~SW & NE & E & SE) | (~NW & ~N & E & S) | (~SW & ~S & E & N);
+            /* 左邻点为1 */
+            b  = r | (NW & SW & ~NE & ~E & ~SE) | (~N & ~NE & ~E & S) | (~SE & ~E & ~S & N);
+#undef N
+#undef NE
+#undef E
+#undef SE
+#undef S
+#undef SW
+#undef NW
+            a &= in;
+            b &= in;
+            if ((a | b) == 0)
+                continue;
+            carry = (k > 0) ? (row[k - 1] >> 63) : 0;
+            f = c;
+            for (;;) {
+                l  = (f << 1) | carry;
+                fn = c & ~((l & b) | (~l & a));
+                if (fn == f)
+                    break;
+                f = fn;
+            }
+            if (f != c) {
+                row[k] = f;
+                changed = FvsTrue;
+            }
+        }
+    }
+    return changed;
+}
+
+
+/******************************************************************************
+  * 功能：细化1位图像，与 ImageThinHitMiss 结果相同
+  *       图像必须是二值化过的
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageThinHitMiss(FvsBitImage_t img) {
+    iFvsBitImage_t* image = (iFvsBitImage_t*)img;
+    FvsInt_t passes = 0;
+    FVS_PROFILE_BEGIN(tprof);
+    if (image->pbits == NULL)
+        return FvsMemory;
+    if (image->flags != FvsImageBinarized)
+        return FvsBadParameter;
+    do {
+        passes++;
+    }
+    while (BitHitMissPass(image) == FvsTrue);
+    (void)BitImageRemoveSpurs(img);
+    image->flags = FvsImageThinned;
+    FVS_PROFILE_END(tprof, FvsProfileThinning, image->w * image->h, passes, 0);
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：去除1位细化图像中的毛刺，与 ImageRemoveSpurs 结果相同
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageRemoveSpurs(FvsBitImage_t img) {
+    iFvsBitImage_t* image = (iFvsBitImage_t*)img;
+    FvsInt_t words = image->words;
+    FvsInt_t y, k, c;
+    FvsUint64_t nb[8], t[8];
+    FvsUint64_t v;
+    FvsUint64_t *del, *cur, *prev;
+    FvsBool_t changed;
+    if (image->pbits == NULL)
+        return FvsOK;
+    del = (FvsUint64_t*)malloc(2 * words * sizeof(FvsUint64_t));
+    if (del == NULL)
+        return FvsMemory;
+    c = 0;
+    do {
+        changed = FvsFalse;
+        for (y = 1; y < image->h - 1; y++) {
+            cur = del + (y & 1) * words;
+            for (k = 0; k < words; k++) {
+                v = image->pbits[y * words + k] & BitInterior(k, image->w);
+                if (v != 0) {
+                    BitNeighbours(image, y, k, nb);
+                    t[0] = ~nb[1] &  nb[0] & ~nb[2];	/* P3==0 && P2!=0 && P4==0 */
+                    t[1] = ~nb[3] &  nb[2] & ~nb[4];	/* P5==0 && P4!=0 && P6==0 */
+                    t[2] = ~nb[5] &  nb[4] & ~nb[6];	/* P7==0 && P6!=0 && P8==0 */
+                    t[3] = ~nb[7] &  nb[6] & ~nb[0];	/* P9==0 && P8!=0 && P2==0 */
+                    t[4] =  nb[1] & ~nb[2];				/* P3!=0 && P4==0 */
+                    t[5] =  nb[3] & ~nb[4];				/* P5!=0 && P6==0 */
+                    t[6] =  nb[5] & ~nb[6];				/* P7!=0 && P8==0 */
+                    t[7] =  nb[7] & ~nb[0];				/* P9!=0 && P2==0 */
+                    v &= BitExactlyOne(t, 8);
+                    if (v != 0)
+                        changed = FvsTrue;
+                }
+                cur[k] = v;
+            }
+            if (y > 1) {
+                prev = del + ((y - 1) & 1) * words;
+                for (k = 0; k < words; k++)
+                    image->pbits[(y - 1) * words + k] &= ~prev[k];
+            }
+        }
+        if (image->h > 2) {
+            y = image->h - 2;
+            cur = del + (y & 1) * words;
+            for (k = 0; k < words; k++)
+                image->pbits[y * words + k] &= ~cur[k];
+        }
+    }
+    while (changed == FvsTrue && ++c < 5);
+    free(del);
+    return FvsOK;
+}
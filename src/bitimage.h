@@ -0,0 +1,138 @@
+/*#############################################################################
+ * 文件名：bitimage.h
+ * 功能：  1位二值图像，用于细化和细节点提取
+#############################################################################*/
+
+#if !defined FVS__BITIMAGE_HEADER__INCLUDED__
+#define FVS__BITIMAGE_HEADER__INCLUDED__
+
+/* 基本类型定义 */
+#include "fvstypes.h"
+#include "image.h"
+
+
+/******************************************************************************
+** 二值化之后的图像只有 0x00 和 0xFF 两种值，每个象素用1位保存即可。
+** 每行用若干个64位的字保存，第x个象素位于第 x/64 个字的第 x%64 位，
+** 行尾多余的位始终为0。这样内存减少到1/8，细化时一条指令处理64个象素。
+**
+** 这里的细化和去毛刺算法与 imagemanip.cpp 中的逐字节实现结果完全相同。
+******************************************************************************/
+
+/* 对象的这些接口实现是私有的，不必为用户所知 */
+typedef FvsHandle_t FvsBitImage_t;
+
+
+/******************************************************************************
+  * 功能：创建一个新的1位图像对象
+  * 参数：无
+  * 返回：失败返回空，否则返回新的图像对象
+******************************************************************************/
+FvsBitImage_t BitImageCreate(void);
+
+
+/******************************************************************************
+  * 功能：销毁一个1位图像对象
+  * 参数：image  指向图像对象的指针
+  * 返回：无
+******************************************************************************/
+void BitImageDestroy(FvsBitImage_t image);
+
+
+/******************************************************************************
+  * 功能：设置1位图像的大小，内容清零
+  * 参数：image   指向图像对象的指针
+  *       width   图像宽度
+  *       height  图像高度
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageSetSize(FvsBitImage_t image, const FvsInt_t width,
+							const FvsInt_t height);
+
+
+/******************************************************************************
+  * 功能：获得图像宽度、高度、每行的字数和缓冲区
+******************************************************************************/
+FvsInt_t BitImageGetWidth(const FvsBitImage_t image);
+FvsInt_t BitImageGetHeight(const FvsBitImage_t image);
+FvsInt_t BitImageGetWords(const FvsBitImage_t image);
+FvsUint64_t* BitImageGetBuffer(FvsBitImage_t image);
+
+
+/******************************************************************************
+  * 功能：获得图像标记
+  * 参数：image  指向图像对象的指针
+  * 返回：图像标记
+******************************************************************************/
+FvsImageFlag_t BitImageGetFlag(const FvsBitImage_t image);
+
+
+/******************************************************************************
+  * 功能：设置图像标记，直接写入缓冲区的函数用它说明内容
+  * 参数：image  指向图像对象的指针
+  *       flag   标记
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageSetFlag(FvsBitImage_t image, const FvsImageFlag_t flag);
+
+
+/******************************************************************************
+  * 功能：统计一个字中每个象素的8邻域中为1的个数。
+  *       结果按位分片保存：第x位的个数为
+  *       count[0]的第x位 + 2*count[1]的第x位 + 4*count[2]... + 8*count[3]...
+  *       y 为 0 或 h-1 时，图像外的行按0处理。
+  * 参数：image   1位图像
+  *       y       行
+  *       k       字的序号
+  *       count   输出的4个字
+  * 返回：无
+******************************************************************************/
+void BitImageNeighbourCount(const FvsBitImage_t image, const FvsInt_t y,
+							const FvsInt_t k, FvsUint64_t count[4]);
+
+
+/******************************************************************************
+  * 功能：由8位图像得到1位图像，非0的象素置1，标记也一起复制
+  * 参数：bits   1位图像
+  *       image  8位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageFromImage(FvsBitImage_t bits, const FvsImage_t image);
+
+
+/******************************************************************************
+  * 功能：由1位图像得到8位图像，1置为0xFF，0置为0x00，标记也一起复制
+  * 参数：image  8位图像
+  *       bits   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageToImage(FvsImage_t image, const FvsBitImage_t bits);
+
+
+/******************************************************************************
+  * 功能：细化1位图像，与 ImageThinConnectivity 结果相同
+  *       图像必须是二值化过的
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageThinConnectivity(FvsBitImage_t image);
+
+
+/******************************************************************************
+  * 功能：细化1位图像，与 ImageThinHitMiss 结果相同
+  *       图像必须是二值化过的
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageThinHitMiss(FvsBitImage_t image);
+
+
+/******************************************************************************
+  * 功能：去除1位细化图像中的毛刺，与 ImageRemoveSpurs 结果相同
+  * 参数：image   1位图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t BitImageRemoveSpurs(FvsBitImage_t image);
+
+
+#endif /* FVS__BITIMAGE_HEADER__INCLUDED__ */
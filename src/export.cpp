@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļexport.cpp
- * ܣ  ָͼ
+ * 文件名：export.cpp
+ * 功能：  指纹图像输出保存
 #############################################################################*/
 
 #include "export.h"
@@ -10,10 +10,10 @@
 
 
 /******************************************************************************
-  * ܣһָͼһļļĸʽļչ
-  * filename  Ҫͼļ
-  *       image     Ҫͼ
-  * أ
+  * 功能：将一个指纹图像输出到一个文件，文件的格式由文件的扩展名决定
+  * 参数：filename  将要保存图像的文件名
+  *       image     将要导出的图像
+  * 返回：错误代码
 ******************************************************************************/
 FvsError_t  FvsImageExport(const FvsImage_t image, const FvsString_t filename,
                            FvsByte_t bmfh[14], BITMAPINFOHEADER *bmih, RGBQUAD *rgbq) {
@@ -39,12 +39,12 @@ FvsError_t  FvsImageExport(const FvsImage_t image, const FvsString_t filename,
         return ret;
     }
     else {
-        /* û */
+        /* 获得缓冲区 */
         buffer = ImageGetBuffer(image);
         pitch  = ImageGetPitch(image);
         height = ImageGetHeight(image);
         width  = ImageGetWidth(image);
-        /*  */
+        /* 拷贝数据 */
         for (i = height - 1; i >= 0; i--) {
             FileWrite(file, buffer + i * pitch, WIDTHBYTES(pitch * 8));
         }
@@ -0,0 +1,188 @@
+
+/*#############################################################################
+ * 文件名：fft.cpp
+ * 功能：  可以重复使用的快速傅立叶变换
+#############################################################################*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fft.h"
+
+
+/* 变换对象 */
+typedef struct iFvsFFT_t {
+    FvsInt_t     size;
+    FvsInt_t*    reverse;          /* 位反转表                   */
+    FvsFloat_t*  wreal;            /* 旋转因子 exp(-2.PI.i.k/N)  */
+    FvsFloat_t*  wimag;            /* k = 0 .. N/2-1             */
+    FvsFloat_t*  real;             /* 工作缓冲区                 */
+    FvsFloat_t*  imag;
+} iFvsFFT_t;
+
+
+/******************************************************************************
+  * 功能：创建一个变换对象
+  * 参数：size  变换的点数，必须是2的幂
+  * 返回：失败返回空，否则返回新的变换对象
+******************************************************************************/
+FvsFFT_t FFTCreate(const FvsInt_t size) {
+    iFvsFFT_t* p;
+    FvsInt_t i, j, bits;
+    FvsFloat_t angle;
+    if (size < 2 || (size & (size - 1)) != 0)
+        return NULL;
+    p = (iFvsFFT_t*)malloc(sizeof(iFvsFFT_t));
+    if (p == NULL)
+        return NULL;
+    p->size    = size;
+    p->reverse = (FvsInt_t*)malloc((size_t)size * sizeof(FvsInt_t));
+    p->wreal   = (FvsFloat_t*)malloc((size_t)size * 2 * sizeof(FvsFloat_t));
+    p->real    = (FvsFloat_t*)malloc((size_t)size * 2 * sizeof(FvsFloat_t));
+    if (p->reverse == NULL || p->wreal == NULL || p->real == NULL) {
+        free(p->reverse);
+        free(p->wreal);
+        free(p->real);
+        free(p);
+        return NULL;
+    }
+    p->wimag = p->wreal + size / 2;
+    p->imag  = p->real + size;
+    for (bits = 0; (1 << bits) < size; bits++)
+        ;
+    for (i = 0; i < size; i++) {
+        p->reverse[i] = 0;
+        for (j = 0; j < bits; j++)
+            if (i & (1 << j))
+                p->reverse[i] |= 1 << (bits - j - 1);
+    }
+    for (i = 0; i < size / 2; i++) {
+        angle = -i * M_PI * 2 / size;
+        p->wreal[i] = cos(angle);
+        p->wimag[i] = sin(angle);
+    }
+    return (FvsFFT_t)p;
+}
+
+
+/******************************************************************************
+  * 功能：销毁一个变换对象
+  * 参数：fft  变换对象
+  * 返回：无
+******************************************************************************/
+void FFTDestroy(FvsFFT_t fft) {
+    iFvsFFT_t* p = (iFvsFFT_t*)fft;
+    if (p == NULL)
+        return;
+    free(p->reverse);
+    free(p->wreal);
+    free(p->real);
+    free(p);
+}
+
+
+/******************************************************************************
+  * 功能：获得变换的点数
+  * 参数：fft  变换对象
+  * 返回：点数
+******************************************************************************/
+FvsInt_t FFTGetSize(const FvsFFT_t fft) {
+    iFvsFFT_t* p = (iFvsFFT_t*)fft;
+    return p->size;
+}
+
+
+/* 数据已经按位反转的顺序排好，原地进行蝶形运算 */
+static void FFTButterfly(const iFvsFFT_t* p, FvsFloat_t* re, FvsFloat_t* im) {
+    FvsInt_t n = p->size;
+    FvsInt_t half, step, i, j, k;
+    FvsFloat_t tr, ti, wr, wi;
+    for (half = 1; half < n; half <<= 1) {
+        step = n / (half * 2);
+        for (j = 0; j < n; j += half * 2)
+            for (i = 0, k = 0; i < half; i++, k += step) {
+                wr = p->wreal[k];
+                wi = p->wimag[k];
+                tr = re[j + i + half] * wr - im[j + i + half] * wi;
+                ti = re[j + i + half] * wi + im[j + i + half] * wr;
+                re[j + i + half] = re[j + i] - tr;
+                im[j + i + half] = im[j + i] - ti;
+                re[j + i] += tr;
+                im[j + i] += ti;
+            }
+    }
+}
+
+
+/******************************************************************************
+  * 功能：原地进行复数的正向变换
+  * 参数：fft   变换对象
+  *       real  实部，size 个
+  *       imag  虚部，size 个
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t FFTForward(FvsFFT_t fft, FvsFloat_t* real, FvsFloat_t* imag) {
+    iFvsFFT_t* p = (iFvsFFT_t*)fft;
+    FvsInt_t i;
+    if (p == NULL || real == NULL || imag == NULL)
+        return FvsMemory;
+    for (i = 0; i < p->size; i++) {
+        p->real[p->reverse[i]] = real[i];
+        p->imag[p->reverse[i]] = imag[i];
+    }
+    FFTButterfly(p, p->real, p->imag);
+    memcpy(real, p->real, (size_t)p->size * sizeof(FvsFloat_t));
+    memcpy(imag, p->imag, (size_t)p->size * sizeof(FvsFloat_t));
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：对多个实数信号做变换，输出幅度谱
+  *       z = x + i.y 变换后：
+  *         X[k] = (Z[k] + conj(Z[N-k])) / 2
+  *         Y[k] = (Z[k] - conj(Z[N-k])) / 2i
+  * 参数：fft        变换对象
+  *       input      count 个信号，每个 size 点，连续存放
+  *       magnitude  输出 count 组幅度谱，每组 size/2+1 个
+  *       count      信号的个数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t FFTMagnitudeReal(FvsFFT_t fft, const FvsFloat_t* input,
+                            FvsFloat_t* magnitude, const FvsInt_t count) {
+    iFvsFFT_t* p = (iFvsFFT_t*)fft;
+    FvsInt_t n, m, c, i, k;
+    const FvsFloat_t* x;
+    const FvsFloat_t* y;
+    FvsFloat_t* mx;
+    FvsFloat_t* my;
+    FvsFloat_t ar, ai, br, bi;
+    if (p == NULL || input == NULL || magnitude == NULL)
+        return FvsMemory;
+    n = p->size;
+    m = n / 2 + 1;
+    for (c = 0; c < count; c += 2) {
+        x  = input + c * n;
+        mx = magnitude + c * m;
+        /* 个数为奇数时，最后一个信号单独变换，虚部为0 */
+        y  = (c + 1 < count) ? x + n : NULL;
+        my = mx + m;
+        for (i = 0; i < n; i++) {
+            p->real[p->reverse[i]] = x[i];
+            p->imag[p->reverse[i]] = (y != NULL) ? y[i] : 0.0;
+        }
+        FFTButterfly(p, p->real, p->imag);
+        for (k = 0; k < m; k++) {
+            /* Z[k] 和 conj(Z[N-k]) */
+            ar = p->real[k];
+            ai = p->imag[k];
+            br =  p->real[(n - k) & (n - 1)];
+            bi = -p->imag[(n - k) & (n - 1)];
+            mx[k] = 0.5 * sqrt((ar + br) * (ar + br) + (ai + bi) * (ai + bi));
+            if (y != NULL)
+                my[k] = 0.5 * sqrt((ar - br) * (ar - br) + (ai - bi) * (ai - bi));
+        }
+    }
+    return FvsOK;
+}
@@ -0,0 +1,72 @@
+/*#############################################################################
+ * 文件名：fft.h
+ * 功能：  可以重复使用的快速傅立叶变换
+#############################################################################*/
+
+#if !defined FVS__FFT_HEADER__INCLUDED__
+#define FVS__FFT_HEADER__INCLUDED__
+
+/* 基本类型定义 */
+#include "fvstypes.h"
+
+
+/******************************************************************************
+** 变换对象在创建时计算好旋转因子和位反转表，并分配工作缓冲区，
+** 以后每次变换都不再计算三角函数，也不再申请内存。
+** 同一个对象不能在多个线程中同时使用，每个线程各自创建一个即可。
+******************************************************************************/
+
+/* 对象的这些接口实现是私有的，不必为用户所知 */
+typedef FvsHandle_t FvsFFT_t;
+
+
+/******************************************************************************
+  * 功能：创建一个变换对象
+  * 参数：size  变换的点数，必须是2的幂
+  * 返回：失败返回空，否则返回新的变换对象
+******************************************************************************/
+FvsFFT_t FFTCreate(const FvsInt_t size);
+
+
+/******************************************************************************
+  * 功能：销毁一个变换对象
+  * 参数：fft  变换对象
+  * 返回：无
+******************************************************************************/
+void FFTDestroy(FvsFFT_t fft);
+
+
+/******************************************************************************
+  * 功能：获得变换的点数
+  * 参数：fft  变换对象
+  * 返回：点数
+******************************************************************************/
+FvsInt_t FFTGetSize(const FvsFFT_t fft);
+
+
+/******************************************************************************
+  * 功能：原地进行复数的正向变换
+  *       X[k] = sum x[n].exp(-2.PI.i.k.n/N)
+  * 参数：fft   变换对象
+  *       real  实部，size 个
+  *       imag  虚部，size 个
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t FFTForward(FvsFFT_t fft, FvsFloat_t* real, FvsFloat_t* imag);
+
+
+/******************************************************************************
+  * 功能：对多个实数信号做变换，输出幅度谱。
+  *       两个实数信号合成一个复数信号变换，再分离出各自的频谱，
+  *       所以每个信号只需要半次复数变换。
+  * 参数：fft        变换对象
+  *       input      count 个信号，每个 size 点，连续存放
+  *       magnitude  输出 count 组幅度谱，每组 size/2+1 个，|X[0]| ... |X[size/2]|
+  *       count      信号的个数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t FFTMagnitudeReal(FvsFFT_t fft, const FvsFloat_t* input,
+                            FvsFloat_t* magnitude, const FvsInt_t count);
+
+
+#endif /* FVS__FFT_HEADER__INCLUDED__ */
@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļfile.cpp
- * ܣ  ʵָļĲ
+ * 文件名：file.cpp
+ * 功能：  实现了指纹相关文件的操作
 #############################################################################*/
 
 #include <stdio.h>
@@ -11,16 +11,16 @@
 #include "file.h"
 
 
-/* Щӿʵ˽еģΪû֪ */
+/* 对象的这些接口实现是私有的，不必为用户所知 */
 typedef struct iFvsFile_t {
-    FILE	*pf;	/* ļָ */
+    FILE	*pf;	/* 文件指针 */
 } iFvsFile_t;
 
 
 /******************************************************************************
-  * ܣһµļֻڴ֮ļΪá
-  * 
-  * أʧܣNULL򷵻µĶ
+  * 功能：创建一个新的文件对象，只有在创建之后，文件对象才能为其它函数所用。
+  * 参数：无
+  * 返回：若创建失败，返回NULL；否则返回新的对象句柄。
 ******************************************************************************/
 FvsFile_t FileCreate() {
     iFvsFile_t* p = NULL;
@@ -32,15 +32,15 @@ FvsFile_t FileCreate() {
 
 
 /******************************************************************************
-  * ܣƻһѾڵļڻٻ֮ļΪá
-  * file  ɾļָ
-  * أ޷ֵ
+  * 功能：破坏一个已经存在的文件对象，在毁坏之后，文件对象不能再为其它函数所用。
+  * 参数：file  即将删除的文件对象指针
+  * 返回：无返回值
 ******************************************************************************/
 void FileDestroy(FvsFile_t file) {
     iFvsFile_t* p = NULL;
     if (file == NULL)
         return;
-    /* رļ */
+    /* 关闭文件，如果它还打开着 */
     (void)FileClose(file);
     p = (iFvsFile_t *)file;
     free(p);
@@ -48,18 +48,18 @@ void FileDestroy(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣһµļһļԶ򿪣д򿪣߱
-  * file    ļ
-  *       name    ļ
-  *       flags   򿪱־
-  * أ
+  * 功能：打开一个新的文件。一个文件可以读打开，写打开，或者被创建。
+  * 参数：file    文件对象
+  *       name    待打开文件的名字
+  *       flags   打开标志
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileOpen(FvsFile_t file, const FvsString_t name,
                     const FvsFileOptions_t flags) {
     iFvsFile_t* p = (iFvsFile_t*)file;
     char strFlags[10];
     int nflags = (int)flags;
-    /* رļѾ */
+    /* 关闭文件，如果已经打开 */
     (void)FileClose(p);
     strcpy(strFlags, "");
     if ( (nflags & FvsFileRead) != 0   &&
@@ -82,9 +82,9 @@ FvsError_t FileOpen(FvsFile_t file, const FvsString_t name,
 
 
 /******************************************************************************
-  * ܣرһļļر֮ļٿá
-  * file    ļ
-  * أ
+  * 功能：关闭一个文件对象，文件关闭之后，文件不再可用。
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileClose(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -100,9 +100,9 @@ FvsError_t FileClose(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣһļǷ
-  * file    ļ
-  * أļ򿪣򷵻true򷵻false
+  * 功能：测试一个文件是否打开
+  * 参数：file    文件对象
+  * 返回：文件打开，则返回true；否则返回false
 ******************************************************************************/
 FvsBool_t FileIsOpen(const FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -111,9 +111,9 @@ FvsBool_t FileIsOpen(const FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣǷļβ
-  * file    ļ
-  * أ˽βtrue򷵻false
+  * 功能：测试是否到了文件结尾
+  * 参数：file    文件对象
+  * 返回：到了结尾，返回true；否则返回false
 ******************************************************************************/
 FvsBool_t FileIsAtEOF(const FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -124,9 +124,9 @@ FvsBool_t FileIsAtEOF(const FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣύļĸ
-  * file    ļ
-  * أ
+  * 功能：提交对文件所作的更改
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileCommit(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -135,9 +135,9 @@ FvsError_t FileCommit(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣļĿͷ
-  * file    ļ
-  * أ
+  * 功能：跳到文件的开头
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeekToBegin(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -151,9 +151,9 @@ FvsError_t FileSeekToBegin(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣļĽβ
-  * file    ļ
-  * أ
+  * 功能：跳到文件的结尾
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeekToEnd(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -167,9 +167,9 @@ FvsError_t FileSeekToEnd(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣõǰļָλ
-  * file    ļ
-  * أǰָλ
+  * 功能：得到当前的文件指针位置
+  * 参数：file    文件对象
+  * 返回：当前的指针位置
 ******************************************************************************/
 FvsUint_t FileGetPosition(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -180,10 +180,10 @@ FvsUint_t FileGetPosition(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣļָλ
-  * file     ļ
-  *       position ָļλ
-  * أ
+  * 功能：跳到文件的指定位置
+  * 参数：file     文件对象
+  *       position 指定的文件位置
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeek(FvsFile_t file, const FvsUint_t position) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -197,11 +197,11 @@ FvsError_t FileSeek(FvsFile_t file, const FvsUint_t position) {
 
 
 /******************************************************************************
-  * ܣļжݣȡֽlengthȡݱָdata
-  * file    ļ
-  *       data    ָ洢ݵ
-  *       length  Ҫȡֽ
-  * أʵʶȡֽ
+  * 功能：从文件中读数据，所读取的字节数由length决定。读取的数据保存于指针data。
+  * 参数：file    文件对象
+  *       data    指向存储数据的数组
+  *       length  要读取的字节数
+  * 返回：实际读取的字节数
 ******************************************************************************/
 FvsUint_t FileRead(FvsFile_t file, FvsPointer_t data, const FvsUint_t length) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -210,11 +210,11 @@ FvsUint_t FileRead(FvsFile_t file, FvsPointer_t data, const FvsUint_t length) {
 
 
 /******************************************************************************
-  * ܣļдݣдֽlengthҪдݱָdata
-  * file    ļ
-  *       data    ָ洢ݵ
-  *       length  Ҫдֽ
-  * أʵдֽ
+  * 功能：往文件中写数据，所写的字节数由length决定。要写入的数据保存于指针data。
+  * 参数：file    文件对象
+  *       data    指向存储数据的数组
+  *       length  要写入的字节数
+  * 返回：实际写入的字节数
 ******************************************************************************/
 FvsUint_t FileWrite(FvsFile_t file, const FvsPointer_t data, const FvsUint_t length) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -223,9 +223,9 @@ FvsUint_t FileWrite(FvsFile_t file, const FvsPointer_t data, const FvsUint_t len
 
 
 /******************************************************************************
-  * ܣļеõһֽ
-  * file    ļ
-  * أȡֽ
+  * 功能：从文件中得到一个字节
+  * 参数：file    文件对象
+  * 返回：读取的字节
 ******************************************************************************/
 FvsByte_t FileGetByte(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
@@ -234,9 +234,9 @@ FvsByte_t FileGetByte(FvsFile_t file) {
 
 
 /******************************************************************************
-  * ܣļжȡһ
-  * file    ļ
-  * أȡ
+  * 功能：从文件中读取一个字
+  * 参数：file    文件对象
+  * 返回：读取的字
 ******************************************************************************/
 FvsWord_t FileGetWord(FvsFile_t file) {
     iFvsFile_t* p = (iFvsFile_t*)file;
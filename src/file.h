@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļfile.h
- * ܣ  ʵָļĲ
+ * 文件名：file.h
+ * 功能：  实现了指纹相关文件的操作
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
@@ -8,14 +8,14 @@
 #define FVS__FILE_HEADER__INCLUDED__
 
 
-/* ͵Ķļ */
+/* 基本类型的定义文件 */
 #include "fvstypes.h"
 
 
-/* Щӿʵ˽еģΪû֪ʹṩĺļ */
+/* 对象的这些接口实现是私有的，不必为用户所知。使用这里提供的函数操作文件 */
 typedef FvsHandle_t FvsFile_t;
 
-/* BITMAPļͷṹ */
+/* BITMAP文件头结构 */
 typedef struct tagBITMAPFILEHEADER { // bmfh 
     FvsWord_t    bfType; 
     FvsDword_t   bfSize; 
@@ -24,7 +24,7 @@ typedef struct tagBITMAPFILEHEADER { // bmfh
     FvsDword_t   bfOffBits; 
 } BITMAPFILEHEADER; 
 
-/* BITMAPϢͷṹ */
+/* BITMAP信息头结构 */
 typedef struct tagBITMAPINFOHEADER{ // bmih 
     FvsDword_t  biSize; 
     FvsDword_t   biWidth;
@@ -39,7 +39,7 @@ typedef struct tagBITMAPINFOHEADER{ // bmih
     FvsDword_t  biClrImportant; 
 } BITMAPINFOHEADER; 
 
-/* BITMAPɫṹ */
+/* BITMAP调色板结构 */
 typedef struct tagRGBQUAD { // rgbq 
     FvsByte_t    rgbBlue; 
     FvsByte_t    rgbGreen; 
@@ -49,143 +49,143 @@ typedef struct tagRGBQUAD { // rgbq
 
 
 /******************************************************************************
-  * ܣһµļֻڴ֮ļΪá
-  * 
-  * أʧܣNULL򷵻µĶ
+  * 功能：创建一个新的文件对象，只有在创建之后，文件对象才能为其它函数所用。
+  * 参数：无
+  * 返回：若创建失败，返回NULL；否则返回新的对象句柄。
 ******************************************************************************/
 extern FvsFile_t FileCreate(void);
 
 
 /******************************************************************************
-  * ܣƻһѾڵļڻٻ֮ļΪá
-  * file  ɾļָ
-  * أ޷ֵ
+  * 功能：破坏一个已经存在的文件对象，在毁坏之后，文件对象不能再为其它函数所用。
+  * 参数：file  即将删除的文件对象指针
+  * 返回：无返回值
 ******************************************************************************/
 extern void FileDestroy(FvsFile_t file);
 
 
-/* ļ򿪺õѡ */
+/* 文件打开函数所用的选项 */
 typedef enum FvsFileOptions_t
 {
-    /*  */
+    /* 读打开 */
     FvsFileRead   = 2,
-    /* д */
+    /* 写打开 */
     FvsFileWrite  = 4,
-    /*  */
+    /* 创建打开 */
     FvsFileCreate = 8
 } FvsFileOptions_t;
 
 
 /******************************************************************************
-  * ܣһµļһļԶ򿪣д򿪣߱
-  * file    ļ
-  *       name    ļ
-  *       flags   򿪱־
-  * أ
+  * 功能：打开一个新的文件。一个文件可以读打开，写打开，或者被创建。
+  * 参数：file    文件对象
+  *       name    待打开文件的名字
+  *       flags   打开标志
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t FileOpen(FvsFile_t file, const FvsString_t name, 
 						const FvsFileOptions_t flags);
 
 
 /******************************************************************************
-  * ܣرһļļر֮ļٿá
-  * file    ļ
-  * أ
+  * 功能：关闭一个文件对象，文件关闭之后，文件不再可用。
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileClose(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣļжݣȡֽlengthȡݱָdata
-  * file    ļ
-  *       data    ָ洢ݵ
-  *       length  Ҫȡֽ
-  * أʵʶȡֽ
+  * 功能：从文件中读数据，所读取的字节数由length决定。读取的数据保存于指针data。
+  * 参数：file    文件对象
+  *       data    指向存储数据的数组
+  *       length  要读取的字节数
+  * 返回：实际读取的字节数
 ******************************************************************************/
 FvsUint_t FileRead(FvsFile_t file, FvsPointer_t data, 
 						const FvsUint_t length);
 
 
 /******************************************************************************
-  * ܣļдݣдֽlengthҪдݱָdata
-  * file    ļ
-  *       data    ָ洢ݵ
-  *       length  Ҫдֽ
-  * أʵдֽ
+  * 功能：往文件中写数据，所写的字节数由length决定。要写入的数据保存于指针data。
+  * 参数：file    文件对象
+  *       data    指向存储数据的数组
+  *       length  要写入的字节数
+  * 返回：实际写入的字节数
 ******************************************************************************/
 FvsUint_t FileWrite(FvsFile_t file, const FvsPointer_t data, 
 						const FvsUint_t length);
 
 
 /******************************************************************************
-  * ܣļеõһֽ
-  * file    ļ
-  * أȡֽ
+  * 功能：从文件中得到一个字节
+  * 参数：file    文件对象
+  * 返回：读取的字节
 ******************************************************************************/
 FvsByte_t FileGetByte(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣļжȡһ
-  * file    ļ
-  * أȡ
+  * 功能：从文件中读取一个字
+  * 参数：file    文件对象
+  * 返回：读取的字
 ******************************************************************************/
 FvsWord_t FileGetWord(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣһļǷ
-  * file    ļ
-  * أļ򿪣򷵻true򷵻false
+  * 功能：测试一个文件是否打开
+  * 参数：file    文件对象
+  * 返回：文件打开，则返回true；否则返回false
 ******************************************************************************/
 FvsBool_t FileIsOpen(const FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣǷļβ
-  * file    ļ
-  * أ˽βtrue򷵻false
+  * 功能：测试是否到了文件结尾
+  * 参数：file    文件对象
+  * 返回：到了结尾，返回true；否则返回false
 ******************************************************************************/
 FvsBool_t FileIsAtEOF(const FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣύļĸ
-  * file    ļ
-  * أ
+  * 功能：提交对文件所作的更改
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileCommit(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣļĿͷ
-  * file    ļ
-  * أ
+  * 功能：跳到文件的开头
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeekToBegin(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣļĽβ
-  * file    ļ
-  * أ
+  * 功能：跳到文件的结尾
+  * 参数：file    文件对象
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeekToEnd(FvsFile_t file);
 
 
 /******************************************************************************
-  * ܣļָλ
-  * file     ļ
-  *       position ָļλ
-  * أ
+  * 功能：跳到文件的指定位置
+  * 参数：file     文件对象
+  *       position 指定的文件位置
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FileSeek(FvsFile_t file, const FvsUint_t position);
 
 
 /******************************************************************************
-  * ܣõǰļָλ
-  * file    ļ
-  * أǰָλ
+  * 功能：得到当前的文件指针位置
+  * 参数：file    文件对象
+  * 返回：当前的指针位置
 ******************************************************************************/
 FvsUint_t FileGetPosition(FvsFile_t file);
 
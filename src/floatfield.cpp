@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļfloatfield.cpp
- * ܣ  ʵָƸĲ
+ * 文件名：floatfield.cpp
+ * 功能：  实现了指纹浮点域的操作
 #############################################################################*/
 
 #include <stdlib.h>
@@ -10,19 +10,19 @@
 
 #include "floatfield.h"
 
-/* ָƸṹ */
+/* 指纹浮点域结构 */
 typedef struct iFvsFloatField_t {
-    FvsFloat_t		*pimg;		/* ָ */
-    FvsInt_t		w;			/*  */
-    FvsInt_t		h;			/* ߶ */
-    FvsInt_t		pitch;		/* б */
+    FvsFieldFloat_t	*pimg;		/* 浮点数指针数组 */
+    FvsInt_t		w;			/* 宽度 */
+    FvsInt_t		h;			/* 高度 */
+    FvsInt_t		pitch;		/* 倾斜度 */
 } iFvsFloatField_t;
 
 
 /******************************************************************************
-  * ܣһĵĸ
-  * 
-  * أʧܣؿգ򷵻µĶ
+  * 功能：创建一个心的浮点域对象
+  * 参数：无
+  * 返回：创建失败，返回空；否则返回新的对象句柄
 ******************************************************************************/
 FvsFloatField_t FloatFieldCreate() {
     iFvsFloatField_t* p = NULL;
@@ -38,9 +38,9 @@ FvsFloatField_t FloatFieldCreate() {
 
 
 /******************************************************************************
-  * ܣƻѾڵĸ
-  * field   ָ򸡵ָ
-  * أ
+  * 功能：破坏已经存在的浮点域对象
+  * 参数：field   指向浮点域对象的指针
+  * 返回：无
 ******************************************************************************/
 void FloatFieldDestroy(FvsFloatField_t field) {
     iFvsFloatField_t* p = NULL;
@@ -53,19 +53,19 @@ void FloatFieldDestroy(FvsFloatField_t field) {
 
 
 /******************************************************************************
-  * ܣøĴС
-          ڴԶɣʧܣһ
-  * field   ָ򸡵ָ
-  *       width   
-  *       height  
-  * أ
+  * 功能：设置浮点域对象的大小。
+          内存操作自动完成，如果失败，返回一个错误编号
+  * 参数：field   指向浮点域对象的指针
+  *       width   宽
+  *       height  高
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FloatFieldSetSize(FvsFloatField_t img, const FvsInt_t width,
                              const FvsInt_t height) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
     FvsError_t nRet = FvsOK;
-    FvsInt_t newsize = (FvsInt_t)(width * height * sizeof(FvsFloat_t));
-    /* СΪ0 */
+    FvsInt_t newsize = (FvsInt_t)(width * height * sizeof(FvsFieldFloat_t));
+    /* 大小为0的情况 */
     if (newsize == 0) {
         if (field->pimg != NULL) {
             free(field->pimg);
@@ -76,13 +76,13 @@ FvsError_t FloatFieldSetSize(FvsFloatField_t img, const FvsInt_t width,
         }
         return FvsOK;
     }
-    if ((FvsInt_t)(field->h * field->w * sizeof(FvsFloat_t)) != newsize) {
+    if ((FvsInt_t)(field->h * field->w * sizeof(FvsFieldFloat_t)) != newsize) {
         free(field->pimg);
         field->w = 0;
         field->h = 0;
         field->pitch = 0;
-        /* ڴ */
-        field->pimg = (FvsFloat_t*)malloc((size_t)newsize);
+        /* 申请内存 */
+        field->pimg = (FvsFieldFloat_t*)malloc((size_t)newsize);
     }
     if (field->pimg == NULL)
         nRet = FvsMemory;
@@ -96,10 +96,10 @@ FvsError_t FloatFieldSetSize(FvsFloatField_t img, const FvsInt_t width,
 
 
 /******************************************************************************
-  * ܣһԴͼĿͼڴʹСòԶ
-  * destination ָĿ긡ָ
-  *       source      ָԴָ
-  * أ
+  * 功能：拷贝一个源图像到目标图像，内存操作和大小重置操作自动完成
+  * 参数：destination 指向目标浮点域对象的指针
+  *       source      指向源浮点域对象的指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FloatFieldCopy(FvsFloatField_t destination,
                           const FvsFloatField_t source) {
@@ -108,15 +108,15 @@ FvsError_t FloatFieldCopy(FvsFloatField_t destination,
     FvsError_t nRet = FvsOK;
     nRet = FloatFieldSetSize(dest, src->w, src->h);
     if (nRet == FvsOK)
-        memcpy(dest->pimg, src->pimg, src->h * src->w * sizeof(FvsFloat_t));
+        memcpy(dest->pimg, src->pimg, src->h * src->w * sizeof(FvsFieldFloat_t));
     return nRet;
 }
 
 
 /******************************************************************************
-  * ܣͼøָΪ
-  * field ָ򸡵ָ
-  * أ
+  * 功能：清空图像，设置浮点域对象指针为空
+  * 参数：field 指向浮点域对象的指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FloatFieldClear(FvsFloatField_t img) {
     return FloatFieldFlood(img, 0.0);
@@ -124,10 +124,10 @@ FvsError_t FloatFieldClear(FvsFloatField_t img) {
 
 
 /******************************************************************************
-  * ܣֵضֵ
-  * field  ָ򸡵ָ
-  *       value  Ҫõֵ
-  * أ
+  * 功能：给浮点域对象的所以数值设置特定值
+  * 参数：field  指向浮点域对象的指针
+  *       value  要设置的值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FloatFieldFlood(FvsFloatField_t img, const FvsFloat_t value) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
@@ -135,59 +135,59 @@ FvsError_t FloatFieldFlood(FvsFloatField_t img, const FvsFloat_t value) {
     FvsInt_t i;
     if (field->pimg != NULL) {
         for (i = 0; i < field->h * field->w; i++)
-            field->pimg[i] = value;
+            field->pimg[i] = (FvsFieldFloat_t)value;
     }
     return nRet;
 }
 
 
 /******************************************************************************
-  * ܣΪеضضֵ
-  * field  ָ򸡵ָ
-  *       x      X
-  *       y      Y
-  *       val    Ҫ趨ֵ
-  * أ
+  * 功能：为浮点域中的特定区域设置特定值
+  * 参数：field  指向浮点域对象的指针
+  *       x      X轴坐标
+  *       y      Y轴坐标
+  *       val    要设定的值
+  * 返回：无
 ******************************************************************************/
 void FloatFieldSetValue(FvsFloatField_t img, const FvsInt_t x,
                         const FvsInt_t y, const FvsFloat_t val) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
     int address = y * field->w + x;
-    field->pimg[address] = val;
+    field->pimg[address] = (FvsFieldFloat_t)val;
 }
 
 
 /******************************************************************************
-  * ܣõضλõֵ
-  * field  ָ򸡵ָ
-  *       x      X
-  *       y      Y
-  * أֵ
+  * 功能：得到特定位置的值
+  * 参数：field  指向浮点域对象的指针
+  *       x      X轴坐标
+  *       y      Y轴坐标
+  * 返回：浮点值
 ******************************************************************************/
 FvsFloat_t FloatFieldGetValue(FvsFloatField_t img, const FvsInt_t x,
                               const FvsInt_t y) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
-    /* еλ */
+    /* 数组中的位置 */
     int address = y * field->pitch + x;
     return field->pimg[address];
 }
 
 
 /******************************************************************************
-  * ܣõ򻺳ָ
-  * field  ָ򸡵ָ
-  * أڴ滺ָ
+  * 功能：得到浮点域缓冲区指针
+  * 参数：field  指向浮点域对象的指针
+  * 返回：内存缓冲区指针
 ******************************************************************************/
-FvsFloat_t* FloatFieldGetBuffer(FvsFloatField_t img) {
+FvsFieldFloat_t* FloatFieldGetBuffer(FvsFloatField_t img) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
     return field->pimg;
 }
 
 
 /******************************************************************************
-  * ܣÿ
-  * field  ָ򸡵ָ
-  * أ
+  * 功能：获得宽度
+  * 参数：field  指向浮点域对象的指针
+  * 返回：宽度
 ******************************************************************************/
 FvsInt_t FloatFieldGetWidth(const FvsFloatField_t img) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
@@ -196,9 +196,9 @@ FvsInt_t FloatFieldGetWidth(const FvsFloatField_t img) {
 
 
 /******************************************************************************
-  * ܣø߶
-  * field  ָ򸡵ָ
-  * أ߶
+  * 功能：获得高度
+  * 参数：field  指向浮点域对象的指针
+  * 返回：高度
 ******************************************************************************/
 FvsInt_t FloatFieldGetHeight(const FvsFloatField_t img) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
@@ -207,9 +207,9 @@ FvsInt_t FloatFieldGetHeight(const FvsFloatField_t img) {
 
 
 /******************************************************************************
-  * ܣб̶
-  * field  ָ򸡵ָ
-  * أб̶
+  * 功能：获得倾斜程度
+  * 参数：field  指向浮点域对象的指针
+  * 返回：倾斜程度
 ******************************************************************************/
 FvsInt_t FloatFieldGetPitch(const FvsFloatField_t img) {
     iFvsFloatField_t* field = (iFvsFloatField_t*)img;
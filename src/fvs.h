@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļfvs.h
- * ܣ  ṩһָʶĿ
+ * 文件名：fvs.h
+ * 功能：  提供了一个指纹识别的框架
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
@@ -9,7 +9,7 @@
 
 
 /**********          Fingerprint Verification System - FVS         ************
-  * ṩûӿڣԴָļָͼ񲢷
+  * 提供了用户接口，可以打开指纹文件，处理指纹图像并分析。
 ******************************************************************************/
 
 
@@ -19,38 +19,62 @@
 #include <math.h>
 #include <string.h>
 
-/* Զļ */
+/* 包含自动配置文件 */
 //#include "config.h"
 
-/* Ͷļ */
+/* 基本类型定义文件 */
 #include "fvstypes.h"
 
-/* ļ/ */
-#include "import.h"		/* Զļ */
-#include "export.h"		/* ָͼļ   */
+/* 文件输入/输出 */
+#include "import.h"		/* 自动检测输入文件的类型 */
+#include "export.h"		/* 将指纹图像输出到文件   */
 
-/* ͼ */
+/* 图像对象 */
 #include "image.h"
 
-/*  */
+/* 1位二值图像 */
+#include "bitimage.h"
+
+/* 浮点域对象 */
 #include "floatfield.h"
 
-/* ļ */
+/* 文件对象 */
 #include "file.h"
 
-/* ϸ */
+/* 处理细节 */
 #include "minutia.h"
 
-/* ֱͼ */
+/* 快速傅立叶变换 */
+#include "fft.h"
+
+/* 旋转采样 */
+#include "sampler.h"
+
+/* 量化的方向 */
+#include "orientation.h"
+
+/* 直方图对象 */
 #include "histogram.h"
 
-/* ͼ */
+/* 图像处理操作 */
 #include "imagemanip.h"
 
-/* ƥ㷨 */
+/* 匹配算法 */
 #include "matching.h"
 
-/* 汾 */
+/* 按名字组装的处理流程 */
+#include "pipeline.h"
+
+/* 多幅图像的流水线处理 */
+#include "batch.h"
+
+/* 各阶段计时 */
+#include "profile.h"
+
+/* 并行处理 */
+#include "parallel.h"
+
+/* 版本 */
 //const FvsString_t FvsGetVersion(void);
 
 #endif /* FVS__GLOBAL_HEADER__INCLUDED__*/
@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļhistogram.cpp
- * ܣ  ʵֱָͼĲ
+ * 文件名：histogram.cpp
+ * 功能：  实现了指纹直方图的操作
 #############################################################################*/
 
 #include <stdlib.h>
@@ -9,26 +9,27 @@
 #include <string.h>
 
 #include "histogram.h"
+#include "parallel.h"
 
-/* ֱͼԿټλͼһЩϢֵ */
+/* 直方图可以快速计算位图的一些信息，比如均值，方差等 */
 typedef struct iFvsHistogram_t {
-    FvsUint_t       ptable[256];    /* 8λͼֱͼ */
-    FvsInt_t        ncount;         /* ֱͼеĵ */
-    FvsInt_t        nmean;          /* -1 = ûм */
-    FvsInt_t        nvariance;      /* -1 = ûм */
+    FvsUint_t       ptable[256];    /* 8位图像的直方图 */
+    FvsInt_t        ncount;         /* 直方图中的点数 */
+    FvsInt_t        nmean;          /* -1 = 还没有计算 */
+    FvsInt_t        nvariance;      /* -1 = 还没有计算 */
 } iFvsHistogram_t;
 
 
 /******************************************************************************
-  * ܣһµֱͼ
-  * 
-  * أʧܷؿգ򷵻ֱͼ
+  * 功能：创建一个新的直方图对象
+  * 参数：无
+  * 返回：失败返回空，否则返回直方图对象
 ******************************************************************************/
 FvsHistogram_t HistogramCreate() {
     iFvsHistogram_t* p = NULL;
     p = (iFvsHistogram_t *)(FvsHistogram_t)malloc(sizeof(iFvsHistogram_t));
     if (p != NULL) {
-        /* ñ */
+        /* 重置表 */
         HistogramReset(p);
     }
     return (FvsHistogram_t)p;
@@ -36,9 +37,9 @@ FvsHistogram_t HistogramCreate() {
 
 
 /******************************************************************************
-  * ܣƻһڵֱͼ
-  * histogram ֱͼָ
-  * أ
+  * 功能：破坏一个存在的直方图对象
+  * 参数：histogram 直方图对象指针
+  * 返回：错误编号
 ******************************************************************************/
 void HistogramDestroy(FvsHistogram_t histogram) {
     iFvsHistogram_t* p = NULL;
@@ -50,9 +51,9 @@ void HistogramDestroy(FvsHistogram_t histogram) {
 
 
 /******************************************************************************
-  * ܣһڵֱͼΪ0
-  * histogram ֱͼָ
-  * أ
+  * 功能：重置一个存在的直方图对象为0
+  * 参数：histogram 直方图对象指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t HistogramReset(FvsHistogram_t hist) {
     iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
@@ -67,54 +68,283 @@ FvsError_t HistogramReset(FvsHistogram_t hist) {
 
 
 /******************************************************************************
-  * ܣһ8-bitͼֱͼ
-  * histogram ֱͼָ
-  *       image     ͼָ
-  * أ
+** 直方图的统计
+**
+** 逐个象素累加同一张表时，相邻象素的值相同（指纹图像的背景大多如此）
+** 会使每次累加都要等上一次写回，所以这里轮流累加4张表，最后再合并。
+******************************************************************************/
+
+/* 统计的区域，mask 为空时统计全部象素 */
+typedef struct HistogramRegion_t {
+    const FvsByte_t* p;
+    FvsInt_t         pitch;
+    const FvsByte_t* m;            /* 掩码，非0的象素才统计 */
+    FvsInt_t         mpitch;
+    FvsInt_t         x0, x1;       /* 列的范围 [x0,x1)      */
+} HistogramRegion_t;
+
+
+/******************************************************************************
+  * 功能：统计 [y0,y1) 行的直方图，累加到 table 中
+  * 参数：r      统计的区域
+  *       y0,y1  行的范围
+  *       table  累加的计数表
+  * 返回：统计的象素个数
+******************************************************************************/
+static FvsInt_t HistogramCountRows(const HistogramRegion_t* r, const FvsInt_t y0,
+                                   const FvsInt_t y1, FvsUint_t table[256]) {
+    FvsUint_t sub[4][256];
+    const FvsByte_t* row;
+    const FvsByte_t* mrow;
+    FvsInt_t x, y, n = 0;
+    memset(sub, 0, sizeof(sub));
+    for (y = y0; y < y1; y++) {
+        row = r->p + y * r->pitch;
+        if (r->m == NULL) {
+            for (x = r->x0; x + 4 <= r->x1; x += 4) {
+                sub[0][row[x]]++;
+                sub[1][row[x + 1]]++;
+                sub[2][row[x + 2]]++;
+                sub[3][row[x + 3]]++;
+            }
+            for (; x < r->x1; x++)
+                sub[0][row[x]]++;
+            n += r->x1 - r->x0;
+        }
+        else {
+            mrow = r->m + y * r->mpitch;
+            for (x = r->x0; x + 4 <= r->x1; x += 4) {
+                sub[0][row[x]]     += (mrow[x] != 0);
+                sub[1][row[x + 1]] += (mrow[x + 1] != 0);
+                sub[2][row[x + 2]] += (mrow[x + 2] != 0);
+                sub[3][row[x + 3]] += (mrow[x + 3] != 0);
+            }
+            for (; x < r->x1; x++)
+                sub[0][row[x]] += (mrow[x] != 0);
+        }
+    }
+    for (x = 0; x < 256; x++) {
+        if (r->m != NULL)
+            n += sub[0][x] + sub[1][x] + sub[2][x] + sub[3][x];
+        table[x] += sub[0][x] + sub[1][x] + sub[2][x] + sub[3][x];
+    }
+    return n;
+}
+
+
+/******************************************************************************
+  * 功能：检查图像和掩码，设置统计区域
+  * 参数：r      输出的统计区域
+  *       image  图像指针
+  *       mask   掩码，可以为空
+  * 返回：错误编号
+******************************************************************************/
+static FvsError_t HistogramSetRegion(HistogramRegion_t* r, const FvsImage_t image,
+                                     const FvsImage_t mask) {
+    r->p      = ImageGetBuffer(image);
+    r->pitch  = ImageGetPitch(image);
+    r->m      = NULL;
+    r->mpitch = 0;
+    r->x0     = 0;
+    r->x1     = ImageGetWidth(image);
+    if (r->p == NULL)
+        return FvsMemory;
+    if (mask != NULL) {
+        if (ImageCompareSize(image, mask) == FvsFalse)
+            return FvsBadParameter;
+        r->m      = ImageGetBuffer(mask);
+        r->mpitch = ImageGetPitch(mask);
+        if (r->m == NULL)
+            return FvsMemory;
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：计算一个8-bit图像的直方图
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t HistogramCompute(FvsHistogram_t hist, const FvsImage_t image) {
+    return HistogramComputeMasked(hist, image, NULL);
+}
+
+
+/******************************************************************************
+  * 功能：计算一个8-bit图像中掩码非0部分的直方图
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       mask      掩码图像，与 image 大小相同；为空时统计整幅图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeMasked(FvsHistogram_t hist, const FvsImage_t image,
+                                  const FvsImage_t mask) {
     iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
-    FvsError_t nRet = FvsOK;
-    FvsInt_t w      = ImageGetWidth(image);
-    FvsInt_t h      = ImageGetHeight(image);
-    FvsInt_t pitch  = ImageGetPitch(image);
-    uint8_t* p      = ImageGetBuffer(image);
-    FvsInt_t x, y;
-    if (histogram == NULL || p == NULL)
+    HistogramRegion_t r;
+    FvsError_t nRet;
+    if (histogram == NULL)
         return FvsMemory;
-    /* ֱͼ */
-    nRet = HistogramReset(hist);
-    /*  */
+    nRet = HistogramSetRegion(&r, image, mask);
+    /* 首先重置直方图 */
+    if (nRet == FvsOK)
+        nRet = HistogramReset(hist);
+    /* 计算 */
+    if (nRet == FvsOK)
+        histogram->ncount = HistogramCountRows(&r, 0, ImageGetHeight(image),
+                                               histogram->ptable);
+    return nRet;
+}
+
+
+/******************************************************************************
+  * 功能：计算一个8-bit图像中矩形区域的直方图，区域超出图像的部分被忽略
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       x, y      区域左上角
+  *       width     区域宽度
+  *       height    区域高度
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeRect(FvsHistogram_t hist, const FvsImage_t image,
+                                const FvsInt_t x, const FvsInt_t y,
+                                const FvsInt_t width, const FvsInt_t height) {
+    iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
+    HistogramRegion_t r;
+    FvsInt_t y0 = y, y1 = y + height;
+    FvsInt_t h  = ImageGetHeight(image);
+    FvsError_t nRet;
+    if (histogram == NULL)
+        return FvsMemory;
+    nRet = HistogramSetRegion(&r, image, NULL);
+    if (nRet == FvsOK)
+        nRet = HistogramReset(hist);
     if (nRet == FvsOK) {
-        FvsInt_t pos;
-        for (y = 0; y < h; y++) {
-            pos = pitch * y;
-            for (x = 0; x < w; x++) {
-                histogram->ptable[p[pos++]]++;
-            }
-        }
-        histogram->ncount = w * h;
+        if (x > r.x0)          r.x0 = x;
+        if (x + width < r.x1)  r.x1 = x + width;
+        if (y0 < 0)            y0 = 0;
+        if (y1 > h)            y1 = h;
+        if (r.x0 < r.x1 && y0 < y1)
+            histogram->ncount = HistogramCountRows(&r, y0, y1, histogram->ptable);
     }
     return nRet;
 }
 
 
+/* 多线程统计时每个带的数据 */
+typedef struct HistogramBand_t {
+    FvsUint_t  table[256];
+    FvsInt_t   count;
+} HistogramBand_t;
+
+typedef struct HistogramBands_t {
+    HistogramRegion_t  region;
+    HistogramBand_t*   bands;
+    FvsInt_t           rows;       /* 每带的行数 */
+    FvsInt_t           h;
+} HistogramBands_t;
+
+
+static void HistogramCountBand(const FvsInt_t index, FvsPointer_t context) {
+    HistogramBands_t* t = (HistogramBands_t*)context;
+    HistogramBand_t*  b = t->bands + index;
+    FvsInt_t y0 = index * t->rows;
+    FvsInt_t y1 = y0 + t->rows;
+    if (y1 > t->h)
+        y1 = t->h;
+    memset(b->table, 0, sizeof(b->table));
+    b->count = HistogramCountRows(&t->region, y0, y1, b->table);
+}
+
+
+/******************************************************************************
+  * 功能：多线程计算直方图，结果与 HistogramComputeMasked 相同。
+  *       图像按行分带，每带统计自己的表，最后合并。
+  *       线程数由 ParallelSetThreadCount 设置。
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       mask      掩码图像，可以为空
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeParallel(FvsHistogram_t hist, const FvsImage_t image,
+                                    const FvsImage_t mask) {
+    iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
+    HistogramBands_t t;
+    FvsInt_t count, i, k;
+    FvsError_t nRet;
+    if (histogram == NULL)
+        return FvsMemory;
+    nRet = HistogramSetRegion(&t.region, image, mask);
+    if (nRet == FvsOK)
+        nRet = HistogramReset(hist);
+    if (nRet != FvsOK)
+        return nRet;
+    t.h = ImageGetHeight(image);
+    /* 每带至少64行，太小的图像不值得分带 */
+    count = ParallelGetThreadCount();
+    if (count > t.h / 64)
+        count = t.h / 64;
+    if (count <= 1) {
+        histogram->ncount = HistogramCountRows(&t.region, 0, t.h, histogram->ptable);
+        return FvsOK;
+    }
+    t.rows  = (t.h + count - 1) / count;
+    count   = (t.h + t.rows - 1) / t.rows;
+    t.bands = (HistogramBand_t*)malloc((size_t)count * sizeof(HistogramBand_t));
+    if (t.bands == NULL)
+        return FvsMemory;
+    ParallelFor(count, HistogramCountBand, &t);
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < 256; k++)
+            histogram->ptable[k] += t.bands[i].table[k];
+        histogram->ncount += t.bands[i].count;
+    }
+    free(t.bands);
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：把一个256项的计数表累加到直方图中
+  * 参数：histogram 直方图对象指针
+  *       table     每个灰度值的象素个数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramAddTable(FvsHistogram_t hist, const FvsUint_t table[256]) {
+    iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
+    FvsInt_t i;
+    if (histogram == NULL || table == NULL)
+        return FvsMemory;
+    for (i = 0; i < 256; i++) {
+        histogram->ptable[i] += table[i];
+        histogram->ncount    += table[i];
+    }
+    /* 均值和方差需要重新计算 */
+    histogram->nmean     = -1;
+    histogram->nvariance = -1;
+    return FvsOK;
+}
+
+
 /******************************************************************************
-  * ܣһֱͼľֵ
-  * histogram ֱͼָ
-  * أֵ
+  * 功能：计算一个直方图对象的均值
+  * 参数：histogram 直方图对象指针
+  * 返回：均值
 ******************************************************************************/
 FvsByte_t HistogramGetMean(const FvsHistogram_t hist) {
     iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
+    FvsUint64_t sum;
     FvsInt_t val, i;
     val = histogram->nmean;
     if (val == -1) {
-        val = 0;
+        /* 用64位累加，大图像不会溢出 */
+        sum = 0;
         for (i = 1; i < 255; i++)
-            val += i * histogram->ptable[i];
+            sum += (FvsUint64_t)i * histogram->ptable[i];
         i = histogram->ncount;
         if (i > 0)
-            val = val / i;
+            val = (FvsInt_t)(sum / (FvsUint64_t)i);
         else
             val = 0;
         histogram->nmean = val;
@@ -124,25 +354,27 @@ FvsByte_t HistogramGetMean(const FvsHistogram_t hist) {
 
 
 /******************************************************************************
-  * ܣһֱͼķ
-  * histogram ֱͼָ
-  * أ
+  * 功能：计算一个直方图对象的方差
+  * 参数：histogram 直方图对象指针
+  * 返回：方差
 ******************************************************************************/
 FvsUint_t HistogramGetVariance(const FvsHistogram_t hist) {
     iFvsHistogram_t* histogram = (iFvsHistogram_t*)hist;
+    FvsUint64_t sum;
     FvsInt_t val;
     FvsInt_t i;
     uint8_t mean;
     val = histogram->nvariance;
     if (val == -1) {
-        /* ֵ */
+        /* 计算均值 */
         mean = HistogramGetMean(hist);
-        val  = 0;
+        /* 用64位累加，大图像不会溢出 */
+        sum  = 0;
         for (i = 0; i < 255; i++)
-            val += histogram->ptable[i] * (i - mean) * (i - mean);
+            sum += (FvsUint64_t)histogram->ptable[i] * (FvsUint64_t)((i - mean) * (i - mean));
         i = histogram->ncount;
         if (i > 0)
-            val = val / i;
+            val = (FvsInt_t)(sum / (FvsUint64_t)i);
         else
             val = 0;
         histogram->nvariance = val;
@@ -1,66 +1,113 @@
 /*#############################################################################
- * ļhistogram.h
- * ܣ  ʵֱָͼĲ
+ * 文件名：histogram.h
+ * 功能：  实现了指纹直方图的操作
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
 #if !defined FVS__HISTOGRAM_HEADER__INCLUDED__
 #define FVS__HISTOGRAM_HEADER__INCLUDED__
 
-/* Ͷ */
+/* 基本类型定义 */
 #include "fvstypes.h"
 #include "image.h"
 
 
-/* Щӿʵ˽еģΪû֪ʹṩĺֱͼ */
+/* 对象的这些接口实现是私有的，不必为用户所知。使用这里提供的函数操作直方图 */
 typedef FvsHandle_t FvsHistogram_t;
 
 
 /******************************************************************************
-  * ܣһµֱͼ
-  * 
-  * أʧܷؿգ򷵻ֱͼ
+  * 功能：创建一个新的直方图对象
+  * 参数：无
+  * 返回：失败返回空，否则返回直方图对象
 ******************************************************************************/
 FvsHistogram_t HistogramCreate(void);
 
 
 /******************************************************************************
-  * ܣƻһڵֱͼ
-  * histogram ֱͼָ
-  * أ
+  * 功能：破坏一个存在的直方图对象
+  * 参数：histogram 直方图对象指针
+  * 返回：错误编号
 ******************************************************************************/
 void HistogramDestroy(FvsHistogram_t histogram);
 
 
 /******************************************************************************
-  * ܣһڵֱͼΪ0
-  * histogram ֱͼָ
-  * أ
+  * 功能：重置一个存在的直方图对象为0
+  * 参数：histogram 直方图对象指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t HistogramReset(FvsHistogram_t histogram);
 
 
 /******************************************************************************
-  * ܣһ8-bitͼֱͼ
-  * histogram ֱͼָ
-  *       image     ͼָ
-  * أ
+  * 功能：计算一个8-bit图像的直方图
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t HistogramCompute(FvsHistogram_t histogram, const FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣһֱͼľֵ
-  * histogram ֱͼָ
-  * أֵ
+  * 功能：计算一个8-bit图像中掩码非0部分的直方图
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       mask      掩码图像，与 image 大小相同；为空时统计整幅图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeMasked(FvsHistogram_t histogram, const FvsImage_t image,
+                                  const FvsImage_t mask);
+
+
+/******************************************************************************
+  * 功能：计算一个8-bit图像中矩形区域的直方图，区域超出图像的部分被忽略
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       x, y      区域左上角
+  *       width     区域宽度
+  *       height    区域高度
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeRect(FvsHistogram_t histogram, const FvsImage_t image,
+                                const FvsInt_t x, const FvsInt_t y,
+                                const FvsInt_t width, const FvsInt_t height);
+
+
+/******************************************************************************
+  * 功能：多线程计算直方图，结果与 HistogramComputeMasked 相同，
+  *       线程数由 ParallelSetThreadCount 设置
+  * 参数：histogram 直方图对象指针
+  *       image     图像指针
+  *       mask      掩码图像，可以为空
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramComputeParallel(FvsHistogram_t histogram, const FvsImage_t image,
+                                    const FvsImage_t mask);
+
+
+/******************************************************************************
+  * 功能：把一个256项的计数表累加到直方图中，用于在其它处理过程中
+  *       顺便统计直方图，而不必再扫描一次图像
+  * 参数：histogram 直方图对象指针
+  *       table     每个灰度值的象素个数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t HistogramAddTable(FvsHistogram_t histogram, const FvsUint_t table[256]);
+
+
+/******************************************************************************
+  * 功能：计算一个直方图对象的均值
+  * 参数：histogram 直方图对象指针
+  * 返回：均值
 ******************************************************************************/
 FvsByte_t HistogramGetMean(const FvsHistogram_t histogram);
 
 
 /******************************************************************************
-  * ܣһֱͼķ
-  * histogram ֱͼָ
-  * أ
+  * 功能：计算一个直方图对象的方差
+  * 参数：histogram 直方图对象指针
+  * 返回：方差
 ******************************************************************************/
 FvsUint_t HistogramGetVariance(const FvsHistogram_t histogram);
 
@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļimage.cpp
- * ܣ  ʵָͼĻ
+ * 文件名：image.cpp
+ * 功能：  实现了指纹图像的基本操作
 #############################################################################*/
 
 #include <stdlib.h>
@@ -14,9 +14,9 @@
 
 
 /******************************************************************************
-  * ܣһµͼ
-  * 
-  * أʧܷؿգ򷵻µͼ
+  * 功能：创建一个新的图像对象
+  * 参数：无
+  * 返回：失败返回空，否则返回新的图像对象
 ******************************************************************************/
 FvsImage_t ImageCreate() {
     iFvsImage_t* p = NULL;
@@ -26,16 +26,16 @@ FvsImage_t ImageCreate() {
         p->w        = 0;
         p->pitch    = 0;
         p->pimg     = NULL;
-        p->flags    = FvsImageGray; /* ȱʡı */
+        p->flags    = FvsImageGray; /* 缺省的标记 */
     }
     return (FvsImage_t)p;
 }
 
 
 /******************************************************************************
-  * ܣһͼ
-  * image  ָͼָ
-  * أ
+  * 功能：销毁一个图像对象
+  * 参数：image  指向图像对象的指针
+  * 返回：无
 ******************************************************************************/
 void ImageDestroy(FvsImage_t image) {
     iFvsImage_t* p = NULL;
@@ -48,10 +48,10 @@ void ImageDestroy(FvsImage_t image) {
 
 
 /******************************************************************************
-  * ܣͼǣò󲿷ɿ⺯Զ
-  * image  ָͼָ
-  *       flag   
-  * أ
+  * 功能：设置图像标记，该操作大部分由库函数自动完成
+  * 参数：image  指向图像对象的指针
+  *       flag   标记
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageSetFlag(FvsImage_t img, const FvsImageFlag_t flag) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -61,9 +61,9 @@ FvsError_t ImageSetFlag(FvsImage_t img, const FvsImageFlag_t flag) {
 
 
 /******************************************************************************
-  * ܣͼ
-  * image  ָͼָ
-  * أͼ
+  * 功能：获得图像标记
+  * 参数：image  指向图像对象的指针
+  * 返回：图像标记
 ******************************************************************************/
 FvsImageFlag_t ImageGetFlag(const FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -72,18 +72,18 @@ FvsImageFlag_t ImageGetFlag(const FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣһͼĴС
-  * image   ָͼָ
-  *       width   ͼ
-  *       height  ͼ߶
-  * أ
+  * 功能：设置一个图像对象的大小
+  * 参数：image   指向图像对象的指针
+  *       width   图像宽度
+  *       height  图像高度
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageSetSize(FvsImage_t img, const FvsInt_t width,
                         const FvsInt_t height) {
     iFvsImage_t* image = (iFvsImage_t*)img;
     FvsError_t nRet = FvsOK;
     FvsInt_t newsize = width * height;
-    /* sizeΪ0 */
+    /* size为0的情况 */
     if (newsize == 0) {
         if (image->pimg != NULL) {
             free(image->pimg);
@@ -99,7 +99,7 @@ FvsError_t ImageSetSize(FvsImage_t img, const FvsInt_t width,
         image->w = 0;
         image->h = 0;
         image->pitch = 0;
-        /* ڴ */
+        /* 申请内存 */
         image->pimg = (uint8_t*)malloc((size_t)newsize);
     }
     if (image->pimg == NULL)
@@ -114,10 +114,10 @@ FvsError_t ImageSetSize(FvsImage_t img, const FvsInt_t width,
 
 
 /******************************************************************************
-  * ܣͼ
-  * destination  ָĿͼָ
-  *       source       ָԴͼָ
-  * أ
+  * 功能：拷贝图像
+  * 参数：destination  指向目标图像对象的指针
+  *       source       指向源图像对象的指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageCopy(FvsImage_t destination, const FvsImage_t source) {
     iFvsImage_t* dest = (iFvsImage_t*)destination;
@@ -126,16 +126,35 @@ FvsError_t ImageCopy(FvsImage_t destination, const FvsImage_t source) {
     nRet = ImageSetSize(dest, src->w, src->h);
     if (nRet == FvsOK)
         memcpy(dest->pimg, src->pimg, (size_t)src->h * src->w);
-    /*  */
+    /* 拷贝标记 */
     dest->flags = src->flags;
     return nRet;
 }
 
 
 /******************************************************************************
-  * ܣͼ
-  * image  ָͼָ
-  * أ
+  * 功能：交换两个图像的内容（缓冲区、大小和标记），不拷贝象素
+  * 参数：image1  指向图像对象的指针
+  *       image2  指向图像对象的指针
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageSwap(FvsImage_t img1, FvsImage_t img2) {
+    iFvsImage_t* image1 = (iFvsImage_t*)img1;
+    iFvsImage_t* image2 = (iFvsImage_t*)img2;
+    iFvsImage_t temp;
+    if (image1 == NULL || image2 == NULL)
+        return FvsMemory;
+    temp    = *image1;
+    *image1 = *image2;
+    *image2 = temp;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：清空图像
+  * 参数：image  指向图像对象的指针
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageClear(FvsImage_t img) {
     return ImageFlood(img, 0);
@@ -143,10 +162,10 @@ FvsError_t ImageClear(FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣͼΪضֵ
-  * image  ָͼָ
-  *       value  Ҫ趨ֵ
-  * أ
+  * 功能：设置图像中所有象素为特定值
+  * 参数：image  指向图像对象的指针
+  *       value  要设定的值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageFlood(FvsImage_t img, const FvsByte_t value) {
     FvsError_t nRet = FvsOK;
@@ -159,12 +178,12 @@ FvsError_t ImageFlood(FvsImage_t img, const FvsByte_t value) {
 
 
 /******************************************************************************
-  * ܣͼĳصֵ
-  * image  ָͼָ
-  *       x      X
-  *       y      Y
-  *       val    Ҫ趨ֵ
-  * أ
+  * 功能：设置图像中某个象素的值
+  * 参数：image  指向图像对象的指针
+  *       x      X轴坐标
+  *       y      Y轴坐标
+  *       val    要设定的值
+  * 返回：无
 ******************************************************************************/
 void ImageSetPixel(FvsImage_t img, const FvsInt_t x, const FvsInt_t y,
                    const FvsByte_t val) {
@@ -175,25 +194,25 @@ void ImageSetPixel(FvsImage_t img, const FvsInt_t x, const FvsInt_t y,
 
 
 /******************************************************************************
-  * ܣͼĳصֵ
-  * image  ָͼָ
-  *       x      X
-  *       y      Y
-  * أصֵ
+  * 功能：获得图像中某个象素的值
+  * 参数：image  指向图像对象的指针
+  *       x      X轴坐标
+  *       y      Y轴坐标
+  * 返回：象素的值
 ******************************************************************************/
 FvsByte_t ImageGetPixel(const FvsImage_t img, const FvsInt_t x,
                         const FvsInt_t y) {
     iFvsImage_t* image = (iFvsImage_t*)img;
-    /* еλ */
+    /* 数组中的位置 */
     int address = y * image->pitch + x;
     return image->pimg[address];
 }
 
 
 /******************************************************************************
-  * ܣͼ񻺳ָ
-  * image  ָͼָ
-  * أָͼڴ滺ָ
+  * 功能：获得图像缓冲区指针
+  * 参数：image  指向图像对象的指针
+  * 返回：指向图像内存缓冲区的指针
 ******************************************************************************/
 FvsByte_t* ImageGetBuffer(FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -204,9 +223,9 @@ FvsByte_t* ImageGetBuffer(FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣͼ
-  * image  ָͼָ
-  * أͼ
+  * 功能：获得图像宽度
+  * 参数：image  指向图像对象的指针
+  * 返回：图像宽度
 ******************************************************************************/
 FvsInt_t ImageGetWidth(const FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -217,9 +236,9 @@ FvsInt_t ImageGetWidth(const FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣͼ߶
-  * image  ָͼָ
-  * أͼ߶
+  * 功能：获得图像高度
+  * 参数：image  指向图像对象的指针
+  * 返回：图像高度
 ******************************************************************************/
 FvsInt_t ImageGetHeight(const FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -230,9 +249,9 @@ FvsInt_t ImageGetHeight(const FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣͼ񻺳ĴС
-  * image  ָͼָ
-  * أС
+  * 功能：获得图像缓冲区的大小
+  * 参数：image  指向图像对象的指针
+  * 返回：缓冲区大小
 ******************************************************************************/
 FvsInt_t ImageGetSize(const FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -243,9 +262,9 @@ FvsInt_t ImageGetSize(const FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣͼб
-  * image  ָͼָ
-  * أб
+  * 功能：获得图像倾斜度
+  * 参数：image  指向图像对象的指针
+  * 返回：倾斜度
 ******************************************************************************/
 FvsInt_t ImageGetPitch(const FvsImage_t img) {
     iFvsImage_t* image = (iFvsImage_t*)img;
@@ -256,10 +275,10 @@ FvsInt_t ImageGetPitch(const FvsImage_t img) {
 
 
 /******************************************************************************
-  * ܣȽͼС
-  * image1  ָͼ1ָ
-  *       image2  ָͼ2ָ
-  * أͼСȣtrue򷵻false
+  * 功能：比较两个图像大小
+  * 参数：image1  指向图像对象1的指针
+  *       image2  指向图像对象2的指针
+  * 返回：若两个图像大小相等，返回true；否则返回false
 ******************************************************************************/
 FvsBool_t ImageCompareSize(const FvsImage_t image1, const FvsImage_t image2) {
     if (ImageGetWidth(image1) != ImageGetWidth(image2))
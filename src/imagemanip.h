@@ -1,31 +1,32 @@
 /*#############################################################################
- * ļimagemanip.h
- * ܣ  ʵҪͼ
+ * 文件名：imagemanip.h
+ * 功能：  实现了主要的图像处理操作
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
 #if !defined FVS__IMAGEMANIP_HEADER__INCLUDED__
 #define FVS__IMAGEMANIP_HEADER__INCLUDED__
 
-/* ͼ */
+/* 包含基本的图像操作函数 */
 #include "img_base.h"
 #include "floatfield.h"
+#include "bitimage.h"
 
 
 
 /******************************************************************************
-  * ܣָͼߵķ
-          㷨жͼ˹һҶԱȶȽϸߣ
-          ĴЧҲϺá
-          ֵ-PI/2PI/2֮䣬Ⱥͼͬ
-          ѡȡĿԽ󣬷ЧҲԽãĴʱҲԽ
-          ָͼм߷ı仯ȽϻԵͨ˲ԽϺõ
-          ǵеʹ
-  * image          ָͼָ
-  *       field          ָ򸡵ָ룬
-  *       nBlockSize     С
-  *       nFilterSize    ˲С
-  * أ
+  * 功能：计算指纹图像脊线的方向。
+          该算法在许多论文中都有描述，如果图像做了归一化，并且对比度较高，
+          则最后的处理效果也较好。
+          方向的值在-PI/2和PI/2之间，弧度和脊并不相同。
+          选取的块越大，分析的效果也越好，但所需的处理计算时间也越长。
+          由于指纹图像中脊线方向的变化比较缓慢，所以低通滤波器可以较好的
+          过虑掉方向中的噪声和错误。
+  * 参数：image          指向图像对象的指针
+  *       field          指向浮点域对象的指针，保存结果
+  *       nBlockSize     块大小
+  *       nFilterSize    滤波器大小
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t FingerprintGetDirection(const FvsImage_t image, 
 								FvsFloatField_t field,
@@ -34,11 +35,24 @@ extern FvsError_t FingerprintGetDirection(const FvsImage_t image,
 
 
 /******************************************************************************
-  * ܣȡƵ
-  * image      ָͼ֮ȡƵ
-  *       direction  ߷
-  *       frequency  Ƶ
-  * أ
+  * 功能：方向图的低通滤波，FingerprintGetDirection 在 nFilterSize>0 时调用
+  * 参数：theta        未滤波的角度（2倍方向角），w*h
+  *       out          输出的方向，w*h
+  *       nFilterSize  滤波器大小
+  *       w, h         宽度和高度
+  * 返回：错误编号
+******************************************************************************/
+extern FvsError_t FingerprintDirectionLowPass(FvsFieldFloat_t* theta,
+								FvsFieldFloat_t* out, FvsInt_t nFilterSize,
+								FvsInt_t w, FvsInt_t h);
+
+
+/******************************************************************************
+  * 功能：获取脊线频率
+  * 参数：image      指纹图像，由之提取方向频率
+  *       direction  脊线方向
+  *       frequency  脊线频率
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t FingerprintGetFrequency(const FvsImage_t image, 
 							const FvsFloatField_t direction,
@@ -46,11 +60,11 @@ extern FvsError_t FingerprintGetFrequency(const FvsImage_t image,
 
 
 /******************************************************************************
-  * ܣ޸ĺĻȡƵ
-  * image      ָͼ֮ȡƵ
-  *       direction  ߷
-  *       frequency  Ƶ
-  * أ
+  * 功能：修改后的获取脊线频率
+  * 参数：image      指纹图像，由之提取方向频率
+  *       direction  脊线方向
+  *       frequency  脊线频率
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t FingerprintGetFrequency1(const FvsImage_t image, 
 							const FvsFloatField_t direction,
@@ -60,16 +74,48 @@ extern FvsError_t FingerprintGetFrequency2(const FvsImage_t image,
 							const FvsFloatField_t direction,
 							FvsFloatField_t frequency);
 
+
 /******************************************************************************
-  * ܣȡָͼЧԽнһĴ
-  *       ĳ򲻿ãΪ0
-  *       ߽磬㣬ͼܲ
-  *       ЧΪ255
-  * image        ָͼ
-  *       direction    ߷
-  *       frequency    Ƶ
-  *       mask         
-  * أ
+  * 功能：按块获取脊线频率。每个 16 x 16 的块只计算一次 x-signature，
+  *       无效块由相邻块插值，再双线性插值到每个象素，
+  *       FingerprintGetFrequency 则对每个象素各计算一次
+  * 参数：image      指纹图像，由之提取方向频率
+  *       direction  脊线方向
+  *       frequency  脊线频率，无效的象素为0
+  * 返回：错误编号
+******************************************************************************/
+extern FvsError_t FingerprintGetFrequencyBlock(const FvsImage_t image, 
+							const FvsFloatField_t direction,
+							FvsFloatField_t frequency);
+
+/******************************************************************************
+  * 功能：用分块的二维频谱一次得到脊线方向、频率、掩码和质量，
+  *       可以代替 FingerprintGetDirection、FingerprintGetFrequency1
+  *       和 FingerprintGetMask 三个步骤
+  * 参数：image      归一化后的指纹图像
+  *       direction  输出的脊线方向
+  *       frequency  输出的脊线频率，掩码之外为0
+  *       mask       输出的掩码，有效区域为255
+  *       quality    输出的质量 [0,1]，可以为空
+  * 返回：错误编号
+******************************************************************************/
+extern FvsError_t FingerprintAnalyzeSpectral(const FvsImage_t image,
+							FvsFloatField_t direction,
+							FvsFloatField_t frequency,
+							FvsImage_t mask,
+							FvsFloatField_t quality);
+
+
+/******************************************************************************
+  * 功能：获取指纹图像的有效区域，以进行进一步的处理。
+  *       如果某个区域不可用用，则掩码置为0，包括如下区域：
+  *       边界，背景点，图像质量很差的区域。
+  *       有效区域的掩码置为255。
+  * 参数：image        指纹图像
+  *       direction    脊线方向
+  *       frequency    脊线频率
+  *       mask         输出的掩码
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t FingerprintGetMask(const FvsImage_t image, 
 							const FvsFloatField_t direction,
@@ -78,69 +124,206 @@ extern FvsError_t FingerprintGetMask(const FvsImage_t image,
 
 
 /******************************************************************************
-  * ܣϸָͼ
-  *       ͼǶֵģֻ0x00oxFF
-  *       㷨жϣĳظȥǱ
-  * image   ָͼ
-  * أ
+  * 功能：细化指纹图像
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  *       该算法基于领域的判断，决定某个象素该移去还是保留
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t ImageThinConnectivity(FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣϸָͼʹáHit and MissṹԪء
-  *       ͼǶֵģֻ0x00oxFF
-  *       㷨ȱǲܶαα
-  *       㷨ǳҪ
-  * image   ָͼ
-  * أ
+  * 功能：细化指纹图像，使用“Hit and Miss”结构元素。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  *       该算法的缺点是产生很多伪造的线条（伪特征），
+  *       必须由另外的算法来消除，后处理非常必要。
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageThinHitMiss(FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣͼŲ
-  * image       ָͼ
-  *       size        ŵͼС
-  *       tolerance   ȥֱͼı߽
-  * أ
+  * 功能：去除细化图像中的毛刺，细化函数结束时会调用
+  * 参数：image   细化后的指纹图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageRemoveSpurs(FvsImage_t image);
+
+
+/* 细化算法 */
+typedef enum FvsThinMethod_t
+{
+	FvsThinConnectivity = 0,	/* 同 ImageThinConnectivity */
+	FvsThinHitMiss      = 1		/* 同 ImageThinHitMiss      */
+} FvsThinMethod_t;
+
+
+/******************************************************************************
+  * 功能：查表细化指纹图像，3x3邻域编码为8位索引，用256项的表决定是否删除。
+  *       结果与 ImageThinConnectivity / ImageThinHitMiss 完全相同。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image    指纹图像
+  *       method   细化算法
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinTable(FvsImage_t image, const FvsThinMethod_t method);
+
+
+/******************************************************************************
+  * 功能：工作表细化指纹图像，第一遍之后只重新判断被删除点的邻点，
+  *       工作量与脊线长度成正比。
+  *       结果与 ImageThinConnectivity / ImageThinHitMiss 完全相同。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image    指纹图像
+  *       method   细化算法
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinWorkList(FvsImage_t image, const FvsThinMethod_t method);
+
+
+/******************************************************************************
+  * 功能：多线程细化指纹图像，图像分成若干行带并行处理，
+  *       每个子迭代同步一次，结果与 ImageThinConnectivity 完全相同。
+  *       线程数由 ParallelSetThreadCount 设置。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image   指纹图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinConnectivityParallel(FvsImage_t image);
+
+
+/******************************************************************************
+  * 功能：图像缩放操作
+  * 参数：image       指纹图像
+  *       size        缩放的图像块大小
+  *       tolerance   消去直方图的边界
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageLocalStretch(FvsImage_t image, const FvsInt_t size, 
 								const FvsInt_t tolerance);
 
 
 /******************************************************************************
-  * ܣͼ㷨
-  * image   ָͼ
-  * أ
+  * 功能：局部归一化，每个象素按所在区域的均值和方差归一化到给定值，
+  *       各块的参数双线性插值。适用于对比度不均匀的图像。
+  * 参数：image     指纹图像
+  *       size      块大小，统计窗口为 2size x 2size
+  *       mean      给定的均值
+  *       variance  给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageNormalizeLocal(FvsImage_t image, const FvsInt_t size,
+                               const FvsByte_t mean, const FvsUint_t variance);
+
+
+/******************************************************************************
+  * 功能：图像膨胀算法
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageDilate(FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣͼʴ㷨
-  * image   ָͼ
-  * أ
+  * 功能：图像腐蚀算法
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageErode(FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣָͼǿ㷨
-  *       㷨ȽϸӣĲǻGabor˲ģ
-          ̬㡣ͼʱθı䣬Ҫһԭͼıݡ
-  * image        ָͼ
-  *       direction    ߷Ҫȼ
-  *       frequency    ƵʣҪȼ
-  *       mask         ָʾָƵЧ
-  *       radius       ˲뾶£4.0ɡ
-                       ֵԽܵƣα
-  * أ
+  * 功能：按半径膨胀或腐蚀二值图像，结果与连续调用 radius 次
+  *       ImageDilate / ImageErode 相同，但只扫描图像3遍
+  * 参数：image    指纹图像
+  *       radius   半径（4邻域距离）
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageDilateRadius(FvsImage_t image, const FvsInt_t radius);
+FvsError_t ImageErodeRadius(FvsImage_t image, const FvsInt_t radius);
+
+
+/******************************************************************************
+  * 功能：指纹图像增强算法
+  *       该算法描述起来比较复杂，其后处理的部分是基于Gabor滤波器的，
+          参数动态计算。图像处理时参数依次改变，所以要做一个原图的备份。
+  * 参数：image        指纹图像
+  *       direction    脊线方向，需要事先计算
+  *       frequency    脊线频率，需要事先计算
+  *       mask         指示指纹的有效区域
+  *       radius       滤波器半径，大多数情况下，4.0即可。
+                       值越大，噪声可以受到更大抑制，但会产生更多的伪特征。
+  * 返回：错误编号
 ******************************************************************************/
 extern FvsError_t ImageEnhanceGabor(FvsImage_t image, const FvsFloatField_t direction,
              const FvsFloatField_t frequency, const FvsImage_t mask, 
              const FvsFloat_t radius);
 
 
+/* Gabor 滤波的几种实现 */
+typedef enum FvsGaborFilter_t
+{
+	FvsGaborFull     = 0,	/* 每点计算完整的Gabor核   */
+	FvsGaborAdaptive = 1,	/* 按邻近频率差调整核宽度  */
+	FvsGaborTable    = 2	/* 高斯部分查表            */
+} FvsGaborFilter_t;
+
+
+/******************************************************************************
+  * 功能：使用指定的滤波器实现进行指纹图像增强，参数同 ImageEnhanceGabor
+  * 参数：filter  滤波器实现，ImageEnhanceGabor 使用 FvsGaborTable
+  * 返回：错误编号
+******************************************************************************/
+extern FvsError_t ImageEnhanceGaborFilter(FvsImage_t image, const FvsFloatField_t direction,
+             const FvsFloatField_t frequency, const FvsImage_t mask, 
+             const FvsFloat_t radius, const FvsGaborFilter_t filter);
+
+
+/******************************************************************************
+  * 功能：指纹图像增强并二值化，等价于 ImageEnhanceGabor 之后再
+  *       ImageBinarize(image, limit)，但不生成中间的灰度增强图像
+  * 参数：limit  二值化阈值
+  *       bits   不为空时结果写入1位图像，image 保持不变；
+  *              为空时二值化结果写回 image
+  * 返回：错误编号
+******************************************************************************/
+extern FvsError_t ImageEnhanceGaborBinarize(FvsImage_t image, const FvsFloatField_t direction,
+             const FvsFloatField_t frequency, const FvsImage_t mask,
+             const FvsFloat_t radius, const FvsByte_t limit, FvsBitImage_t bits);
+
+
+
+/******************************************************************************
+  * 功能：FingerprintEnhanceTiled 每完成一块调用的回调，
+  *       可能在多个线程中同时调用
+  * 参数：tile     完成的块的序号
+  *       context  调用者的参数
+  * 返回：返回false时不再开始新的块
+******************************************************************************/
+typedef FvsBool_t (*FvsTileProgress_t)(const FvsInt_t tile, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：分块完成方向、频率、掩码和增强，各块可以并行处理。
+  *       结果与依次调用 FingerprintGetDirection(image, direction, 7, 8)、
+  *       FingerprintGetFrequency1、FingerprintGetMask 和 ImageEnhanceGabor 相同
+  * 参数：image      归一化后的指纹图像，输出增强后的图像
+  *       direction  输出的脊线方向
+  *       frequency  输出的脊线频率
+  *       mask       输出的掩码
+  *       radius     滤波器半径
+  *       tileSize   块的大小，小于等于0时使用缺省值：多线程时为 256，
+  *                  单线程时整幅图像为一块
+  *       progress   每块完成后调用，可以为空
+  *       context    传给 progress 的参数
+  * 返回：错误编号，被取消时返回 FvsFailure，输出只有部分块有效
+******************************************************************************/
+extern FvsError_t FingerprintEnhanceTiled(FvsImage_t image, FvsFloatField_t direction,
+             FvsFloatField_t frequency, FvsImage_t mask,
+             const FvsFloat_t radius, const FvsInt_t tileSize,
+             FvsTileProgress_t progress, FvsPointer_t context);
+
 #endif /* FVS__IMAGEMANIP_HEADER__INCLUDED__ */
 
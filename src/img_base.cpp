@@ -1,12 +1,13 @@
 /*#############################################################################
- * ļimg_base.cpp
- * ܣ  һЩͼ
+ * 文件名：img_base.cpp
+ * 功能：  一些基本的图像操作
 #############################################################################*/
 
 
 #include "img_base.h"
 
 #include "histogram.h"
+#include "profile.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -14,32 +15,34 @@
 
 
 /******************************************************************************
-  * ܣͼֵ
-  * image       ָͼ
-  *       size        ֵ
-  * أ
+  * 功能：图像二值化
+  * 参数：image       指纹图像
+  *       size        阈值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageBinarize(FvsImage_t image, const FvsByte_t limit) {
     FvsInt_t n;
     FvsByte_t *pimg = ImageGetBuffer(image);
     FvsInt_t size = ImageGetSize(image);
+    FVS_PROFILE_BEGIN(tprof);
     if (pimg == NULL)
         return FvsMemory;
-    /* ѭ */
+    /* 循环遍历 */
     for (n = 0; n < size; n++, pimg++) {
-        /* ֵ */
+        /* 阈值化 */
         *pimg = (*pimg < limit) ? (FvsByte_t)0xFF : (FvsByte_t)0x00;
     }
+    FVS_PROFILE_END(tprof, FvsProfileBinarize, size, 0, 0);
     return ImageSetFlag(image, FvsImageBinarized);
 }
 
 /******************************************************************************
-  * ܣͼֵ
-  * ridgeimage  ԭָͼ룬ֵͼ
-  * valleyimage ֵͼ
-  * highsize        ֵ
-  * lowsize        ֵ
-  * أ
+  * 功能：图像二值化
+  * 参数：ridgeimage  原指纹图像输入，二值化脊图像输出
+  * 参数：valleyimage 二值化谷图像
+  * 参数：highsize        阈值
+  * 参数：lowsize        阈值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MyImageBinarize(FvsImage_t ridgeimage, FvsImage_t valleyimage, FvsByte_t highsize, FvsByte_t lowsize) {
     FvsInt_t n;
@@ -48,9 +51,9 @@ FvsError_t MyImageBinarize(FvsImage_t ridgeimage, FvsImage_t valleyimage, FvsByt
     FvsInt_t size = ImageGetSize(ridgeimage);
     if (ridge_pimg == NULL || valley_pimg == NULL)
         return FvsMemory;
-    /* ѭ */
+    /* 循环遍历 */
     for (n = 0; n < size; n++, ridge_pimg++, valley_pimg++) {
-        /* ֵ */
+        /* 阈值化 */
         *ridge_pimg = (*ridge_pimg < lowsize) ? (FvsByte_t)0x00 : (FvsByte_t)0xFF;
         *valley_pimg = (*ridge_pimg > highsize) ? (FvsByte_t)0x00 : (FvsByte_t)0xFF;
     }
@@ -61,9 +64,9 @@ FvsError_t MyImageBinarize(FvsImage_t ridgeimage, FvsImage_t valleyimage, FvsByt
 
 
 /******************************************************************************
-  * ܣͼת
-  * image       ָͼ
-  * أ
+  * 功能：图像翻转操作
+  * 参数：image       指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageInvert(FvsImage_t image) {
     FvsByte_t* pimg = ImageGetBuffer(image);
@@ -79,10 +82,10 @@ FvsError_t ImageInvert(FvsImage_t image) {
 
 
 /******************************************************************************
-  * ܣͼϲ
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像合并操作
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageAverage(FvsImage_t image1, const FvsImage_t image2) {
     FvsByte_t* p1 = ImageGetBuffer(image1);
@@ -103,10 +106,10 @@ FvsError_t ImageAverage(FvsImage_t image1, const FvsImage_t image2) {
 
 
 /******************************************************************************
-  * ܣͼ߼ϲ
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像逻辑合并操作
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageLogical
 (
@@ -153,11 +156,11 @@ FvsError_t ImageLogical
 
 
 /******************************************************************************
-  * ܣͼϲ
-  *       ʹģ㣬0255Ľ0һ127
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像合并操作
+  *       使用了模计算，0和255的结果是0而不是上一个函数的127。
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageAverageModulo(FvsImage_t image1, const FvsImage_t image2) {
     FvsByte_t* p1 = ImageGetBuffer(image1);
@@ -185,11 +188,11 @@ FvsError_t ImageAverageModulo(FvsImage_t image1, const FvsImage_t image2) {
 
 
 /******************************************************************************
-  * ܣͼƽƲ
-  * image    ָͼ
-  *       vx       Xƽ
-  *       vy       Yƽ
-  * أ
+  * 功能：图像平移操作
+  * 参数：image    指纹图像
+  *       vx       X方向的平移量
+  *       vy       Y方向的平移量
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageTranslate(FvsImage_t image, const FvsInt_t vx, const FvsInt_t vy) {
     return FvsOK;
@@ -200,10 +203,10 @@ FvsError_t ImageTranslate(FvsImage_t image, const FvsInt_t vx, const FvsInt_t vy
 
 
 /******************************************************************************
-  * ܣͼ
-  * image       ָͼ
-  *       horizontal  ˮƽֱ
-  * أ
+  * 功能：图像纹理
+  * 参数：image       指纹图像
+  *       horizontal  水平或垂直纹理
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageStripes(FvsImage_t image, const FvsBool_t horizontal) {
     FvsByte_t* p = ImageGetBuffer(image);
@@ -228,74 +231,36 @@ FvsError_t ImageStripes(FvsImage_t image, const FvsBool_t horizontal) {
 
 
 /******************************************************************************
-  * ܣıͼķȣʹ[255..255]֮䶯
-  * image         ָͼ
-  *       luminosity    صķ
-  * أ
+  * 功能：改变图像的发光度，使其在[255..255]之间变动
+  * 参数：image         指纹图像
+  *       luminosity    相关的发光度
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageLuminosity(FvsImage_t image, const FvsInt_t luminosity) {
-    FvsByte_t* p = ImageGetBuffer(image);
-    FvsInt_t  w = ImageGetWidth (image);
-    FvsInt_t  h = ImageGetHeight(image);
-    FvsInt_t pitch = ImageGetPitch (image);
-    FvsInt_t x, y;
-    FvsFloat_t fgray, a, b;
-    if (p == NULL)
-        return FvsMemory;
-    if (luminosity > 0) {
-        a = (255.0 - abs(luminosity)) / 255.0;
-        b = (FvsFloat_t)luminosity;
-    }
-    else {
-        a = (255.0 - abs(luminosity)) / 255.0;
-        b = 0.0;
-    }
-    for (y = 0; y < h; y++)
-        for (x = 0; x < w; x++) {
-            fgray = (FvsFloat_t)P(x, y);
-            fgray = b + a * fgray;
-            if (fgray < 0.0)    fgray = 0.0;
-            if (fgray > 255.0)  fgray = 255.0;
-            P(x, y) = (uint8_t)fgray;
-        }
-    return FvsOK;
+    FvsByte_t lut[256];
+    LutLuminosity(lut, luminosity);
+    return ImageApplyLut(image, lut);
 }
 
 
 /******************************************************************************
-  * ܣıͼĶԱȶȣʹ[-127..127]䶯
-  * image      ָͼ
-  *       contrast   Աȶ
-  * أ
+  * 功能：改变图像的对比度，使其在[-127..127]变动
+  * 参数：image      指纹图像
+  *       contrast   对比度因子
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageContrast(FvsImage_t image, const FvsInt_t contrast) {
-    FvsByte_t* p = ImageGetBuffer(image);
-    FvsInt_t  w = ImageGetWidth (image);
-    FvsInt_t  h = ImageGetHeight(image);
-    FvsInt_t pitch = ImageGetPitch (image);
-    FvsInt_t x, y;
-    FvsFloat_t fgray, a, b;
-    if (p == NULL)
-        return FvsMemory;
-    a = (FvsFloat_t)((127.0 + contrast) / 127.0);
-    b = (FvsFloat_t)(-contrast);
-    for (y = 0; y < h; y++)
-        for (x = 0; x < w; x++) {
-            fgray = (FvsFloat_t)P(x, y);
-            fgray = b + a * fgray;
-            if (fgray < 0.0)    fgray = 0.0;
-            if (fgray > 255.0)  fgray = 255.0;
-            P(x, y) = (uint8_t)fgray;
-        }
-    return FvsOK;
+    FvsByte_t lut[256];
+    LutContrast(lut, contrast);
+    return ImageApplyLut(image, lut);
 }
 
 
 /******************************************************************************
-  * ܣͼֵͨʵ
-  * image     ָͼ
-  *       size      ڴС
-  * أ
+  * 功能：图像软化操作，通过计算均值实现
+  * 参数：image     指纹图像
+  *       size      软化窗口大小
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageSoftenMean(FvsImage_t image, const FvsInt_t size) {
     FvsByte_t* p1  = ImageGetBuffer(image);
@@ -306,14 +271,15 @@ FvsError_t ImageSoftenMean(FvsImage_t image, const FvsInt_t size) {
     FvsInt_t pitch2;
     FvsInt_t x, y, s, p, q, a, c;
     FvsImage_t im2;
+    FVS_PROFILE_BEGIN(tprof);
     im2 = ImageCreate();
     if (im2 == NULL || p1 == NULL)
         return FvsMemory;
-    s = size >> 1;		/* С */
-    a = size * size;	/*  */
+    s = size >> 1;		/* 大小 */
+    a = size * size;	/* 面积 */
     if (a == 0)
         return FvsBadParameter;
-    /* ͼм */
+    /* 拷贝图像进行计算 */
     ImageCopy(im2, image);
     p2 = ImageGetBuffer(im2);
     if (p2 == NULL) {
@@ -331,54 +297,305 @@ FvsError_t ImageSoftenMean(FvsImage_t image, const FvsInt_t size) {
             p1[x + y * pitch] = c / a;
         }
     ImageDestroy(im2);
+    FVS_PROFILE_END(tprof, FvsProfileSoften, w * h, 0, 0);
     return FvsOK;
 }
 
 
 /******************************************************************************
-  * ܣͼһʹиľֵͷ
-  * image     ָͼ
-  *       mean      ľֵ
-  *       variance  ı׼
-  * أ
+  * 功能：图像归一化操作，使其具有给定的均值和方差
+  * 参数：image     指纹图像
+  *       mean      给定的均值
+  *       variance  给定的标准方差
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageNormalize(FvsImage_t image, const FvsByte_t mean, const FvsUint_t variance) {
-    FvsByte_t* p = ImageGetBuffer(image);
-    FvsInt_t   w = ImageGetWidth (image);
-    FvsInt_t   h = ImageGetHeight(image);
-    FvsInt_t   pitch = ImageGetPitch (image);
-    FvsInt_t   x, y;
-    FvsFloat_t fmean, fsigma, fmean0, fsigma0, fgray;
-    FvsFloat_t fcoeff = 0.0;
+    FvsByte_t lut[256];
     FvsHistogram_t histogram = NULL;
-    FvsError_t nRet;
-    if (p == NULL)
+    FvsError_t nRet = FvsMemory;
+    FVS_PROFILE_BEGIN(tprof);
+    if (ImageGetBuffer(image) == NULL)
         return FvsMemory;
     histogram = HistogramCreate();
     if (histogram != NULL) {
-        /* ֱͼ */
+        /* 计算直方图 */
         nRet = HistogramCompute(histogram, image);
-        if (nRet == FvsOK) {
-            /* 㷽;ֵ */
-            fmean   = (FvsFloat_t)HistogramGetMean(histogram);
-            fsigma  = sqrt((FvsFloat_t)HistogramGetVariance(histogram));
-            fmean0  = (FvsFloat_t)mean;
-            fsigma0 = sqrt((FvsFloat_t)variance);
-            if (fsigma > 0.0)
-                fcoeff = fsigma0 / fsigma;
-            for (y = 0; y < h; y++)
-                for (x = 0; x < w; x++) {
-                    fgray = (FvsFloat_t)P(x, y);
-                    fgray = fmean0 + fcoeff * (fgray - mean);
-                    if (fgray < 0.0)    fgray = 0.0;
-                    if (fgray > 255.0)  fgray = 255.0;
-                    P(x, y) = (uint8_t)fgray;
+        /* 由均值和方差得到查找表 */
+        if (nRet == FvsOK)
+            nRet = LutNormalize(lut, histogram, mean, variance);
+        if (nRet == FvsOK)
+            nRet = ImageApplyLut(image, lut);
+        HistogramDestroy(histogram);
+    }
+    FVS_PROFILE_END(tprof, FvsProfileNormalize, ImageGetSize(image), 0, 0);
+    return nRet;
+}
+
+
+/******************************************************************************
+  * 功能：只用掩码非0部分（指纹的前景）的均值和方差对图像进行归一化，
+  *       背景不会影响前景的对比度。整幅图像都按同一张表变换。
+  * 参数：image     指纹图像
+  *       mask      掩码图像，与 image 大小相同；为空时与 ImageNormalize 相同
+  *       mean      给定的均值
+  *       variance  给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageNormalizeMasked(FvsImage_t image, const FvsImage_t mask,
+                                const FvsByte_t mean, const FvsUint_t variance) {
+    FvsByte_t lut[256];
+    FvsHistogram_t histogram = NULL;
+    FvsError_t nRet = FvsMemory;
+    FVS_PROFILE_BEGIN(tprof);
+    if (ImageGetBuffer(image) == NULL)
+        return FvsMemory;
+    histogram = HistogramCreate();
+    if (histogram != NULL) {
+        nRet = HistogramComputeMasked(histogram, image, mask);
+        if (nRet == FvsOK)
+            nRet = LutNormalize(lut, histogram, mean, variance);
+        if (nRet == FvsOK)
+            nRet = ImageApplyLut(image, lut);
+        HistogramDestroy(histogram);
+    }
+    FVS_PROFILE_END(tprof, FvsProfileNormalize, ImageGetSize(image), 0, 0);
+    return nRet;
+}
+
+
+/******************************************************************************
+  * 功能：图像软化和归一化合并为一步，结果与先调用 ImageSoftenMean(size)
+  *       再调用 ImageNormalize(mean, variance) 相同。
+  *       均值滤波按列和、行和滑动累加，每个象素的代价与窗口大小无关；
+  *       软化的同时统计直方图，归一化只是查一次256项的表。
+  *       整幅图像只读写两次，也没有浮点运算。
+  * 参数：image     指纹图像
+  *       size      软化窗口大小
+  *       mean      给定的均值
+  *       variance  给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageSoftenNormalize(FvsImage_t image, const FvsInt_t size,
+                                const FvsByte_t mean, const FvsUint_t variance) {
+    FvsByte_t* p   = ImageGetBuffer(image);
+    FvsInt_t   w   = ImageGetWidth (image);
+    FvsInt_t   h   = ImageGetHeight(image);
+    FvsInt_t pitch = ImageGetPitch (image);
+    FvsInt_t s     = size >> 1;		/* 大小 */
+    FvsInt_t a     = size * size;	/* 面积 */
+    FvsInt_t x, y, c;
+    FvsByte_t* out = NULL;
+    FvsByte_t* row;
+    FvsInt_t* colsum = NULL;
+    FvsUint_t table[256];
+    FvsByte_t lut[256];
+    FvsHistogram_t histogram = NULL;
+    FvsError_t nRet = FvsOK;
+    FVS_PROFILE_BEGIN(tprof);
+    if (p == NULL)
+        return FvsMemory;
+    if (a == 0)
+        return FvsBadParameter;
+    out    = (FvsByte_t*)malloc((size_t)w * h);
+    colsum = (FvsInt_t*)malloc((size_t)w * sizeof(FvsInt_t));
+    histogram = HistogramCreate();
+    if (out == NULL || colsum == NULL || histogram == NULL)
+        nRet = FvsMemory;
+    if (nRet == FvsOK) {
+        memset(table, 0, sizeof(table));
+        /* 第 s 行的列和：第 0 ~ 2s 行 */
+        memset(colsum, 0, (size_t)w * sizeof(FvsInt_t));
+        for (y = 0; y <= 2 * s && y < h; y++)
+            for (x = 0; x < w; x++)
+                colsum[x] += P(x, y);
+        for (y = 0; y < h; y++) {
+            row = out + y * w;
+            /* 边缘的象素保持不变 */
+            memcpy(row, p + y * pitch, (size_t)w);
+            if (y >= s && y < h - s && w > 2 * s) {
+                c = 0;
+                for (x = 0; x <= 2 * s; x++)
+                    c += colsum[x];
+                for (x = s; x < w - s; x++) {
+                    row[x] = (FvsByte_t)(c / a);
+                    if (x + s + 1 < w)
+                        c += colsum[x + s + 1] - colsum[x - s];
                 }
+                /* 下一行的列和 */
+                if (y + s + 1 < h)
+                    for (x = 0; x < w; x++)
+                        colsum[x] += P(x, y + s + 1) - P(x, y - s);
+            }
+            for (x = 0; x < w; x++)
+                table[row[x]]++;
         }
-        HistogramDestroy(histogram);
+        FVS_PROFILE_END(tprof, FvsProfileSoften, w * h, 0, 0);
+    }
+    if (nRet == FvsOK)
+        nRet = HistogramAddTable(histogram, table);
+    if (nRet == FvsOK) {
+        FVS_PROFILE_BEGIN(tnorm);
+        (void)LutNormalize(lut, histogram, mean, variance);
+        for (y = 0; y < h; y++) {
+            row = out + y * w;
+            for (x = 0; x < w; x++)
+                P(x, y) = lut[row[x]];
+        }
+        FVS_PROFILE_END(tnorm, FvsProfileNormalize, w * h, 0, 0);
     }
+    HistogramDestroy(histogram);
+    free(colsum);
+    free(out);
     return nRet;
 }
 
 
+/******************************************************************************
+** 查找表
+**
+** 8位图像上的点运算（亮度、对比度、归一化等）只依赖于象素本身的值，
+** 所以都可以表示为一个256项的表。先按原来的浮点公式算出这张表，
+** 再对每个象素查一次表，结果与逐点计算完全相同。
+** 几个点运算连续进行时，可以先用 LutCompose 把表合成一张，只扫描一次图像。
+******************************************************************************/
+
+
+/******************************************************************************
+  * 功能：对图像的每个象素查表
+  * 参数：image  指纹图像
+  *       lut    256项的查找表
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageApplyLut(FvsImage_t image, const FvsByte_t lut[256]) {
+    FvsByte_t* p   = ImageGetBuffer(image);
+    FvsInt_t w     = ImageGetWidth (image);
+    FvsInt_t h     = ImageGetHeight(image);
+    FvsInt_t pitch = ImageGetPitch (image);
+    FvsByte_t* row;
+    FvsInt_t x, y;
+    FvsByte_t a, b, c, d;
+    if (p == NULL || lut == NULL)
+        return FvsMemory;
+    for (y = 0; y < h; y++) {
+        row = p + y * pitch;
+        /* 每次处理4个象素，4次查表互不依赖 */
+        for (x = 0; x + 4 <= w; x += 4) {
+            a = lut[row[x]];
+            b = lut[row[x + 1]];
+            c = lut[row[x + 2]];
+            d = lut[row[x + 3]];
+            row[x]     = a;
+            row[x + 1] = b;
+            row[x + 2] = c;
+            row[x + 3] = d;
+        }
+        for (; x < w; x++)
+            row[x] = lut[row[x]];
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：生成不改变象素值的查找表
+  * 参数：lut  输出的查找表
+  * 返回：无
+******************************************************************************/
+void LutIdentity(FvsByte_t lut[256]) {
+    FvsInt_t i;
+    for (i = 0; i < 256; i++)
+        lut[i] = (FvsByte_t)i;
+}
+
 
+/******************************************************************************
+  * 功能：生成 ImageLuminosity 的查找表
+  * 参数：lut         输出的查找表
+  *       luminosity  相关的发光度
+  * 返回：无
+******************************************************************************/
+void LutLuminosity(FvsByte_t lut[256], const FvsInt_t luminosity) {
+    FvsFloat_t fgray, a, b;
+    FvsInt_t i;
+    if (luminosity > 0) {
+        a = (255.0 - abs(luminosity)) / 255.0;
+        b = (FvsFloat_t)luminosity;
+    }
+    else {
+        a = (255.0 - abs(luminosity)) / 255.0;
+        b = 0.0;
+    }
+    for (i = 0; i < 256; i++) {
+        fgray = b + a * (FvsFloat_t)i;
+        if (fgray < 0.0)    fgray = 0.0;
+        if (fgray > 255.0)  fgray = 255.0;
+        lut[i] = (uint8_t)fgray;
+    }
+}
+
+
+/******************************************************************************
+  * 功能：生成 ImageContrast 的查找表
+  * 参数：lut       输出的查找表
+  *       contrast  对比度因子
+  * 返回：无
+******************************************************************************/
+void LutContrast(FvsByte_t lut[256], const FvsInt_t contrast) {
+    FvsFloat_t fgray, a, b;
+    FvsInt_t i;
+    a = (FvsFloat_t)((127.0 + contrast) / 127.0);
+    b = (FvsFloat_t)(-contrast);
+    for (i = 0; i < 256; i++) {
+        fgray = b + a * (FvsFloat_t)i;
+        if (fgray < 0.0)    fgray = 0.0;
+        if (fgray > 255.0)  fgray = 255.0;
+        lut[i] = (uint8_t)fgray;
+    }
+}
+
+
+/******************************************************************************
+  * 功能：由直方图生成 ImageNormalize 的查找表
+  * 参数：lut        输出的查找表
+  *       histogram  图像的直方图
+  *       mean       给定的均值
+  *       variance   给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t LutNormalize(FvsByte_t lut[256], const FvsHistogram_t histogram,
+                        const FvsByte_t mean, const FvsUint_t variance) {
+    FvsFloat_t fsigma, fmean0, fsigma0, fgray;
+    FvsFloat_t fcoeff = 0.0;
+    FvsInt_t i;
+    if (histogram == NULL)
+        return FvsMemory;
+    fsigma  = sqrt((FvsFloat_t)HistogramGetVariance(histogram));
+    fmean0  = (FvsFloat_t)mean;
+    fsigma0 = sqrt((FvsFloat_t)variance);
+    if (fsigma > 0.0)
+        fcoeff = fsigma0 / fsigma;
+    for (i = 0; i < 256; i++) {
+        fgray = fmean0 + fcoeff * ((FvsFloat_t)i - mean);
+        if (fgray < 0.0)    fgray = 0.0;
+        if (fgray > 255.0)  fgray = 255.0;
+        lut[i] = (uint8_t)fgray;
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：合成两个查找表，结果等于先查 first 再查 second
+  * 参数：result  输出的查找表，可以与 first 或 second 相同
+  *       first   先进行的点运算
+  *       second  后进行的点运算
+  * 返回：无
+******************************************************************************/
+void LutCompose(FvsByte_t result[256], const FvsByte_t first[256],
+                const FvsByte_t second[256]) {
+    FvsByte_t temp[256];
+    FvsInt_t i;
+    for (i = 0; i < 256; i++)
+        temp[i] = second[first[i]];
+    memcpy(result, temp, sizeof(temp));
+}
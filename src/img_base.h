@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļimg_base.h
- * ܣ  һЩͼ
+ * 文件名：img_base.h
+ * 功能：  一些基本的图像操作
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
@@ -8,6 +8,7 @@
 #define FVS__IMAGE_BASE_HEADER__INCLUDED__
 
 #include "image.h"
+#include "histogram.h"
 
 typedef enum FvsLogical_t
 {
@@ -21,118 +22,179 @@ typedef enum FvsLogical_t
 
 
 /******************************************************************************
-  * ܣͼֵ
-  * image       ָͼ
-  *       size        ֵ
-  * أ
+  * 功能：图像二值化
+  * 参数：image       指纹图像
+  *       size        阈值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageBinarize(FvsImage_t image, const FvsByte_t limit);
 
 
 /******************************************************************************
-  * ܣͼֵ
-  * ridgeimage  ԭָͼ룬ֵͼ
-  * valleyimage ֵͼ
-  * highsize        ֵ
-  * lowsize        ֵ
-  * أ
+  * 功能：图像二值化
+  * 参数：ridgeimage  原指纹图像输入，二值化脊图像输出
+  * 参数：valleyimage 二值化谷图像
+  * 参数：highsize        阈值
+  * 参数：lowsize        阈值
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MyImageBinarize(FvsImage_t ridgeimage,FvsImage_t valleyimage,FvsByte_t highsize,FvsByte_t lowsize);
 
 
 
 /******************************************************************************
-  * ܣͼת
-  * image       ָͼ
-  * أ
+  * 功能：图像翻转操作
+  * 参数：image       指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageInvert(FvsImage_t image);
 
 
 /******************************************************************************
-  * ܣͼϲ
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像合并操作
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageAverage(FvsImage_t image1, const FvsImage_t image2);
 
 
 /******************************************************************************
-  * ܣͼϲ
-  *       ʹģ㣬0255Ľ0һ127
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像合并操作
+  *       使用了模计算，0和255的结果是0而不是上一个函数的127。
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageAverageModulo(FvsImage_t image1, const FvsImage_t image2);
 
 
 /******************************************************************************
-  * ܣͼ߼ϲ
-  * image1    һָͼڱ
-  *       image2    ڶָͼ
-  * أ
+  * 功能：图像逻辑合并操作
+  * 参数：image1    第一个指纹图像，用于保存结果
+  *       image2    第二个指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageLogical(FvsImage_t image1,  const FvsImage_t image2,  const FvsLogical_t operation);
 
 
 /******************************************************************************
-  * ܣͼƽƲ
-  * image    ָͼ
-  *       vx       Xƽ
-  *       vy       Yƽ
-  * أ
+  * 功能：图像平移操作
+  * 参数：image    指纹图像
+  *       vx       X方向的平移量
+  *       vy       Y方向的平移量
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageTranslate(FvsImage_t image, const FvsInt_t vx, const FvsInt_t vy);
 
 
 /******************************************************************************
-  * ܣͼ
-  * image       ָͼ
-  *       horizontal  ˮƽֱ
-  * أ
+  * 功能：图像纹理
+  * 参数：image       指纹图像
+  *       horizontal  水平或垂直纹理
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageStripes(FvsImage_t image, const FvsBool_t horizontal);
 
 
 /******************************************************************************
-  * ܣͼһʹиľֵͷ
-  * image     ָͼ
-  *       mean      ľֵ
-  *       variance  ı׼
-  * أ
+  * 功能：图像归一化操作，使其具有给定的均值和方差
+  * 参数：image     指纹图像
+  *       mean      给定的均值
+  *       variance  给定的标准方差
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageNormalize(FvsImage_t image, const FvsByte_t mean, const FvsUint_t variance);
 
 
 /******************************************************************************
-  * ܣıͼķȣʹ[255..255]֮䶯
-  * image         ָͼ
-  *       luminosity    صķ
-  * أ
+  * 功能：只用掩码非0部分的均值和方差对图像进行归一化
+  * 参数：image     指纹图像
+  *       mask      掩码图像，为空时与 ImageNormalize 相同
+  *       mean      给定的均值
+  *       variance  给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageNormalizeMasked(FvsImage_t image, const FvsImage_t mask,
+                                const FvsByte_t mean, const FvsUint_t variance);
+
+
+/******************************************************************************
+  * 功能：改变图像的发光度，使其在[255..255]之间变动
+  * 参数：image         指纹图像
+  *       luminosity    相关的发光度
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageLuminosity(FvsImage_t image, const FvsInt_t luminosity);
 
 
 /******************************************************************************
-  * ܣıͼĶԱȶȣʹ[-127..127]䶯
-  * image      ָͼ
-  *       contrast   Աȶ
-  * أ
+  * 功能：改变图像的对比度，使其在[-127..127]变动
+  * 参数：image      指纹图像
+  *       contrast   对比度因子
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageContrast(FvsImage_t image, const FvsInt_t contrast);
 
 
 /******************************************************************************
-  * ܣͼֵͨʵ
-  * image     ָͼ
-  *       size      ڴС
-  * أ
+  * 功能：图像软化操作，通过计算均值实现
+  * 参数：image     指纹图像
+  *       size      软化窗口大小
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageSoftenMean(FvsImage_t image, const FvsInt_t size);
 
 
+/******************************************************************************
+  * 功能：图像软化和归一化合并为一步，与先调用 ImageSoftenMean 再调用
+  *       ImageNormalize 的结果相同，但只扫描两次图像，归一化通过查表完成
+  * 参数：image     指纹图像
+  *       size      软化窗口大小
+  *       mean      给定的均值
+  *       variance  给定的方差
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageSoftenNormalize(FvsImage_t image, const FvsInt_t size,
+                                const FvsByte_t mean, const FvsUint_t variance);
+
+
+/******************************************************************************
+  * 功能：对图像的每个象素查表，8位图像上的点运算都可以这样完成
+  * 参数：image  指纹图像
+  *       lut    256项的查找表
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageApplyLut(FvsImage_t image, const FvsByte_t lut[256]);
+
+
+/******************************************************************************
+  * 功能：生成各种点运算的查找表，结果与相应的图像操作逐点计算相同
+  *       LutIdentity    不改变象素值
+  *       LutLuminosity  ImageLuminosity
+  *       LutContrast    ImageContrast
+  *       LutNormalize   ImageNormalize，均值和方差由直方图得到
+  * 参数：lut  输出的查找表，其它参数同相应的图像操作
+******************************************************************************/
+void LutIdentity(FvsByte_t lut[256]);
+void LutLuminosity(FvsByte_t lut[256], const FvsInt_t luminosity);
+void LutContrast(FvsByte_t lut[256], const FvsInt_t contrast);
+FvsError_t LutNormalize(FvsByte_t lut[256], const FvsHistogram_t histogram,
+                        const FvsByte_t mean, const FvsUint_t variance);
+
+
+/******************************************************************************
+  * 功能：合成两个查找表，结果等于先查 first 再查 second，
+  *       几个点运算连续进行时只需扫描一次图像
+  * 参数：result  输出的查找表，可以与 first 或 second 相同
+  *       first   先进行的点运算
+  *       second  后进行的点运算
+  * 返回：无
+******************************************************************************/
+void LutCompose(FvsByte_t result[256], const FvsByte_t first[256],
+                const FvsByte_t second[256]);
+
+
 #endif /* FVS__IMAGE_BASE_HEADER__INCLUDED__ */
 
 
@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļimageenhance.cpp
- * ܣ  ʵͼǿ㷨
+ * 文件名：imageenhance.cpp
+ * 功能：  实现了图像增强算法
 #############################################################################*/
 
 #include <math.h>
@@ -10,35 +10,37 @@
 #include <string.h>
 
 #include "imagemanip.h"
+#include "profile.h"
+#include "parallel.h"
 
 
 /******************************************************************************
-** ͼǿ
+** 图像增强部分
 **
-** ǿ㷨ָͼƣָͼûʹõ򣬶
-** ǿ󣬼߿Աķʹһֵ
+** 该增强算法针对指纹图像设计，它标记了指纹图像中没有使用的区域，而其它的区域
+** 在增强后，脊线可以被清晰的分离出来（使用一个阈值）。
 **
-** 㷨һ߷ͼһͼ
+** 该算法生成了一个脊线方向图，一个掩码图。
 **
-** ɲοƪ£
+** 可参考如下两篇文章：
 ** 1 - Fingerprint Enhancement: Lin Hong, Anil Jain, Sharathcha Pankanti,
 **     and Ruud Bolle. [Hong96]
 ** 2 - Fingerprint Image Enhancement, Algorithm and Performance Evaluation:
 **     Lin Hong, Yifei Wan and Anil Jain. [Hong98]
 **
-** ǿ㷨ʹ (2) еļ裺
-**  A - һ
-**  B - 㷽ͼ
-**  C - Ƶ
-**  D - 
-**  E - ˲
+** 增强算法使用了 文献(2) 中的几个步骤：
+**  A - 归一化
+**  B - 计算方向图
+**  C - 计算频率
+**  D - 计算区域掩码
+**  E - 滤波
 **
 ******************************************************************************/
 
 #define P(x,y)      ((int32_t)p[(x)+(y)*pitch])
 
 /******************************************************************************
-** Gabor˲£
+** 采用了Gabor方向滤波器，如下：
 **
 **                    / 1|x'     y'  |\
 ** h(x,y:phi,f) = exp|- -|--- + ---| |.cos(2.PI.f.x')
@@ -47,13 +49,13 @@
 ** x' =  x.cos(phi) + y.sin(phi)
 ** y' = -x.sin(phi) + y.cos(phi)
 **
-** £
-**  G һͼ
-**  O ͼ
-**  F Ƶͼ
-**  R ͼ
-**  E ǿͼ
-**  Wg Gabor˲ڴС
+** 定义如下：
+**  G 归一化后的图像
+**  O 方向图
+**  F 频率图
+**  R 掩码图像
+**  E 增强后的图像
+**  Wg Gabor滤波器窗口大小
 **
 **          / 255                                          if R(i,j) = 0
 **         |
@@ -83,8 +85,8 @@ static FvsError_t ImageEnhanceFilter
 (
     FvsImage_t        normalized,
     const FvsImage_t  mask,
-    const FvsFloat_t* orientation,
-    const FvsFloat_t* frequence,
+    const FvsFieldFloat_t* orientation,
+    const FvsFieldFloat_t* frequence,
     FvsFloat_t        radius
 ) {
     FvsInt_t Wg2 = 8;
@@ -97,7 +99,7 @@ static FvsError_t ImageEnhanceFilter
     FvsByte_t* pG     = ImageGetBuffer(normalized);
     FvsFloat_t sum, f, o;
     FvsFloat_t x2, y2, cosdir, sindir;
-    /* ƽ */
+    /* 平方 */
     radius = radius * radius;
     enhanced = ImageCreate();
     if (enhanced == NULL || pG == NULL)
@@ -143,7 +145,7 @@ static FvsError_t ImageEnhanceFilter
                     pE[i + j * pitchE] = (uint8_t)sum;
                 }
             }
-        nRet = ImageCopy(normalized, enhanced);
+        nRet = ImageSwap(normalized, enhanced);
     }
     (void)ImageDestroy(enhanced);
     return nRet;
@@ -151,16 +153,16 @@ static FvsError_t ImageEnhanceFilter
 
 
 /******************************************************************************
-** Gabor˲£
-**	ݴڲ÷ϼ߷16*16
+** 采用了Gabor方向滤波器，如下：
+**	数据窗口采用符合脊线方向的16*16点
 **
 ******************************************************************************/
 static FvsError_t ImageEnhanceFilter1
 (
     FvsImage_t        normalized,
     const FvsImage_t  mask,
-    const FvsFloat_t* orientation,
-    const FvsFloat_t* frequence,
+    const FvsFieldFloat_t* orientation,
+    const FvsFieldFloat_t* frequence,
     FvsFloat_t        radius
 ) {
     FvsInt_t Wg2 = 8;
@@ -173,7 +175,7 @@ static FvsError_t ImageEnhanceFilter1
     FvsByte_t* pG     = ImageGetBuffer(normalized);
     FvsFloat_t sum, f, o, o1, o2, rate = 1.0;
     FvsFloat_t cosdir, sindir, x2, y2;
-    /* ƽ */
+    /* 平方 */
     radius = radius * radius;
     enhanced = ImageCreate();
     if (enhanced == NULL || pG == NULL)
@@ -225,104 +227,334 @@ static FvsError_t ImageEnhanceFilter1
                     pE[i + j * pitchE] = (uint8_t)sum;
                 }
             }
-        nRet = ImageCopy(normalized, enhanced);
+        nRet = ImageSwap(normalized, enhanced);
     }
     (void)ImageDestroy(enhanced);
     return nRet;
 }
 
 
+/* 查表滤波器的窗口半径 */
+#define GABOR_TABLE_R   8
+
+
+/******************************************************************************
+  * 功能：计算查表Gabor滤波器的高斯部分
+  * 参数：expv    输出的高斯表
+  *       radius  滤波器半径的平方
+  * 返回：无
+******************************************************************************/
+static void EnhanceGaborTableInit
+(
+    FvsFloat_t expv[2 * GABOR_TABLE_R + 1][2 * GABOR_TABLE_R + 1],
+    const FvsFloat_t radius
+) {
+    FvsInt_t u, v;
+    for (v = -GABOR_TABLE_R; v <= GABOR_TABLE_R; v++)
+        for (u = -GABOR_TABLE_R; u <= GABOR_TABLE_R; u++) {
+            expv[GABOR_TABLE_R + v][GABOR_TABLE_R + u] = exp(-0.5 * (u * u + v * v) / radius);
+        }
+}
+
+
+/******************************************************************************
+  * 功能：用查表Gabor滤波器计算 (i,j) 点的增强值
+  * 参数：pG       归一化后的图像
+  *       pitchG   图像的行宽
+  *       expv     高斯表
+  *       o        该点的脊线方向
+  *       f        该点的脊线频率
+  * 返回：增强值，已截断到 [0,255]
+******************************************************************************/
+static FvsFloat_t EnhanceGaborTable
+(
+    const FvsByte_t*  pG,
+    const FvsInt_t    pitchG,
+    const FvsInt_t    i,
+    const FvsInt_t    j,
+    FvsFloat_t        expv[2 * GABOR_TABLE_R + 1][2 * GABOR_TABLE_R + 1],
+    const FvsFloat_t  o,
+    const FvsFloat_t  f
+) {
+    FvsInt_t u, v;
+    FvsFloat_t sum = 0.0;
+    FvsFloat_t x2;
+    FvsFloat_t cosdir = cos(o);
+    FvsFloat_t sindir = sin(o);
+    for (v = -GABOR_TABLE_R; v <= GABOR_TABLE_R; v++)
+        for (u = -GABOR_TABLE_R; u <= GABOR_TABLE_R; u++) {
+            x2 = u * cosdir + v * sindir;
+            sum += expv[GABOR_TABLE_R + v][GABOR_TABLE_R + u] * cos(2 * M_PI * x2 * f)
+                   * pG[(i + u) + (j + v) * pitchG];
+        }
+    if (sum > 255.0)
+        sum = 255.0;
+    if (sum < 0.0)
+        sum = 0.0;
+    return sum;
+}
+
+
+/* 按行并行滤波时共用的数据，查表滤波器和合并的二值化共用 */
+typedef struct EnhanceRows_t {
+    const FvsByte_t*        pG;
+    FvsInt_t                pitchG;
+    FvsInt_t                w;
+    FvsInt_t                h;
+    FvsImage_t              mask;
+    const FvsFieldFloat_t*  orientation;
+    const FvsFieldFloat_t*  frequence;
+    FvsFloat_t              expv[2 * GABOR_TABLE_R + 1][2 * GABOR_TABLE_R + 1];
+    FvsByte_t*              pE;          /* 灰度或二值的输出   */
+    FvsInt_t                pitchE;
+    FvsUint64_t*            pB;          /* 1位的输出          */
+    FvsInt_t                words;
+    FvsByte_t               limit;
+} EnhanceRows_t;
+
+
+/* 增强第 j 行，边缘的行由调用者清零 */
+static void EnhanceTableRow(const FvsInt_t index, FvsPointer_t context) {
+    EnhanceRows_t* e = (EnhanceRows_t*)context;
+    FvsInt_t Wg2 = GABOR_TABLE_R;
+    FvsInt_t j   = index + Wg2;
+    FvsInt_t i;
+    for (i = Wg2; i < e->w - Wg2; i++) {
+        if (e->mask == NULL || ImageGetPixel(e->mask, i, j) != 0)
+            e->pE[i + j * e->pitchE] = (uint8_t)EnhanceGaborTable(e->pG, e->pitchG, i, j, e->expv,
+                                       e->orientation[i + j * e->w], e->frequence[i + j * e->w]);
+        else	e->pE[i + j * e->pitchE] = 255;
+    }
+}
+
+
 static FvsError_t ImageEnhanceFilter2
 (
     FvsImage_t        normalized,
     const FvsImage_t  mask,
-    const FvsFloat_t* orientation,
-    const FvsFloat_t* frequence,
+    const FvsFieldFloat_t* orientation,
+    const FvsFieldFloat_t* frequence,
     FvsFloat_t        radius
 ) {
-    FvsInt_t Wg2 = 8;
-    FvsInt_t i, j, u, v;
+    FvsInt_t Wg2 = GABOR_TABLE_R;
     FvsError_t nRet  = FvsOK;
     FvsImage_t enhanced = NULL;
-    FvsInt_t w        = ImageGetWidth (normalized);
-    FvsInt_t h        = ImageGetHeight(normalized);
-    FvsInt_t pitchG   = ImageGetPitch (normalized);
-    FvsByte_t* pG     = ImageGetBuffer(normalized);
-    FvsFloat_t sum, f, o;
-    FvsFloat_t x2, y2, cosdir, sindir;
-    FvsFloat_t expv[17][17];
+    EnhanceRows_t e;
+    e.w       = ImageGetWidth (normalized);
+    e.h       = ImageGetHeight(normalized);
+    e.pitchG  = ImageGetPitch (normalized);
+    e.pG      = ImageGetBuffer(normalized);
+    e.mask    = mask;
+    e.orientation = orientation;
+    e.frequence   = frequence;
     radius = radius * radius;
-    for (v = -Wg2; v <= Wg2; v++)
-        for (u = -Wg2; u <= Wg2; u++) {
-            expv[8 + v][8 + u] = exp(-0.5 * (u * u + v * v) / radius);
-        }
+    EnhanceGaborTableInit(e.expv, radius);
     enhanced = ImageCreate();
-    if (enhanced == NULL || pG == NULL)
+    if (enhanced == NULL || e.pG == NULL)
         return FvsMemory;
     if (nRet == FvsOK)
-        nRet = ImageSetSize(enhanced, w, h);
+        nRet = ImageSetSize(enhanced, e.w, e.h);
     if (nRet == FvsOK) {
-        FvsInt_t pitchE  = ImageGetPitch (enhanced);
-        FvsByte_t* pE    = ImageGetBuffer(enhanced);
-        if (pE == NULL)
+        e.pitchE = ImageGetPitch (enhanced);
+        e.pE     = ImageGetBuffer(enhanced);
+        if (e.pE == NULL)
             return FvsMemory;
         (void)ImageClear(enhanced);
-        for (j = Wg2; j < h - Wg2; j++)
-            for (i = Wg2; i < w - Wg2; i++) {
-                if (mask == NULL || ImageGetPixel(mask, i, j) != 0) {
-                    sum = 0.0;
-                    o = orientation[i + j * w];
-                    f = frequence[i + j * w];
-                    cosdir = cos(o);
-                    sindir = sin(o);
-                    if(i < 140 && i > 120 && j == 85 )
-                        sum = 0.0;
-                    if(j < 128 && j > 120 && i == 162)
-                        sum = 0.0;
-                    for (v = -Wg2; v <= Wg2; v++)
-                        for (u = -Wg2; u <= Wg2; u++) {
-                            x2 = u * cosdir + v * sindir;
-//    y2 = - u*sindir + v*cosdir;
-                            sum += expv[8 + v][8 + u] * cos(2 * M_PI * x2 * f) * pG[(i + u) + (j + v) * pitchG];
-                        }
-                    if (sum > 255.0)
-                        sum = 255.0;
-                    if (sum < 0.0)
-                        sum = 0.0;
-                    pE[i + j * pitchE] = (uint8_t)sum;
-                }
-                else	pE[i + j * pitchE] = 255;
-            }
-        nRet = ImageCopy(normalized, enhanced);
+        /* 各行互不影响，每行一个任务 */
+        ParallelFor(e.h - 2 * Wg2, EnhanceTableRow, &e);
+        /* 交换缓冲区，不必再拷贝一次 */
+        nRet = ImageSwap(normalized, enhanced);
     }
     (void)ImageDestroy(enhanced);
     return nRet;
 }
 
 
+/******************************************************************************
+** 增强和二值化合并为一步：查表滤波器的结果直接与阈值比较，不再生成灰度的
+** 增强图像，也省去了 ImageBinarize 对整幅图像的一次扫描。
+** 结果与 ImageEnhanceGabor 之后再 ImageBinarize(limit) 完全相同，各处都按
+** 增强值 < limit 判断：
+**   边缘 Wg2 个象素（增强后为0）        -> limit > 0 时为 0xFF
+**   掩码之外（增强后为255）             -> 总是 0x00
+**   其它                                -> 增强值 < limit 时为 0xFF
+** bits 不为空时结果写入1位图像，原图像保持不变；否则写回原图像。
+******************************************************************************/
+/* 增强并二值化第 j 行 */
+static void EnhanceBinarizeRow(const FvsInt_t j, FvsPointer_t context) {
+    EnhanceRows_t* e = (EnhanceRows_t*)context;
+    FvsInt_t Wg2 = GABOR_TABLE_R;
+    FvsByte_t edge    = 0;      /* 边缘增强后的值     */
+    FvsByte_t outside = 255;    /* 掩码之外增强后的值 */
+    FvsInt_t i;
+    FvsBool_t ridge;
+    for (i = 0; i < e->w; i++) {
+        if (j < Wg2 || j >= e->h - Wg2 || i < Wg2 || i >= e->w - Wg2)
+            ridge = (edge < e->limit) ? FvsTrue : FvsFalse;
+        else if (e->mask == NULL || ImageGetPixel(e->mask, i, j) != 0)
+            ridge = ((uint8_t)EnhanceGaborTable(e->pG, e->pitchG, i, j, e->expv,
+                     e->orientation[i + j * e->w], e->frequence[i + j * e->w]) < e->limit)
+                    ? FvsTrue : FvsFalse;
+        else
+            ridge = (outside < e->limit) ? FvsTrue : FvsFalse;
+        /* 每行从字的边界开始，各行写不同的字 */
+        if (e->pB != NULL) {
+            if (ridge == FvsTrue)
+                e->pB[j * e->words + (i >> 6)] |= (FvsUint64_t)1 << (i & 63);
+        }
+        else
+            e->pE[i + j * e->pitchE] = (ridge == FvsTrue) ? (FvsByte_t)0xFF : (FvsByte_t)0x00;
+    }
+}
+
+
+static FvsError_t ImageEnhanceFilter2Binarize
+(
+    FvsImage_t        normalized,
+    const FvsImage_t  mask,
+    const FvsFieldFloat_t* orientation,
+    const FvsFieldFloat_t* frequence,
+    FvsFloat_t        radius,
+    const FvsByte_t   limit,
+    FvsBitImage_t     bits
+) {
+    FvsError_t nRet  = FvsOK;
+    FvsImage_t binarized = NULL;
+    EnhanceRows_t e;
+    e.w       = ImageGetWidth (normalized);
+    e.h       = ImageGetHeight(normalized);
+    e.pitchG  = ImageGetPitch (normalized);
+    e.pG      = ImageGetBuffer(normalized);
+    e.mask    = mask;
+    e.orientation = orientation;
+    e.frequence   = frequence;
+    e.limit   = limit;
+    e.pE      = NULL;
+    e.pB      = NULL;
+    e.pitchE  = 0;
+    e.words   = 0;
+    if (e.pG == NULL)
+        return FvsMemory;
+    radius = radius * radius;
+    EnhanceGaborTableInit(e.expv, radius);
+    if (bits != NULL) {
+        nRet = BitImageSetSize(bits, e.w, e.h);
+        if (nRet != FvsOK)
+            return nRet;
+        e.pB    = BitImageGetBuffer(bits);
+        e.words = BitImageGetWords(bits);
+        if (e.pB == NULL)
+            return FvsMemory;
+    }
+    else {
+        binarized = ImageCreate();
+        if (binarized == NULL)
+            return FvsMemory;
+        nRet = ImageSetSize(binarized, e.w, e.h);
+        e.pE     = ImageGetBuffer(binarized);
+        e.pitchE = ImageGetPitch (binarized);
+        if (nRet == FvsOK && e.pE == NULL)
+            nRet = FvsMemory;
+    }
+    if (nRet == FvsOK) {
+        ParallelFor(e.h, EnhanceBinarizeRow, &e);
+        if (binarized != NULL) {
+            nRet = ImageSwap(normalized, binarized);
+            if (nRet == FvsOK)
+                nRet = ImageSetFlag(normalized, FvsImageBinarized);
+        }
+        else  /* 重复使用的1位图像可能还标记为细化过的 */
+            nRet = BitImageSetFlag(bits, FvsImageBinarized);
+    }
+    ImageDestroy(binarized);
+    return nRet;
+}
+
+
 
 /******************************************************************************
-  * ܣָͼǿ㷨
-  *       㷨ȽϸӣĲǻGabor˲ģ
-          ̬㡣ͼʱθı䣬Ҫһԭͼıݡ
-  * image        ָͼ
-  *       direction    ߷Ҫȼ
-  *       frequency    ƵʣҪȼ
-  *       mask         ָʾָƵЧ
-  *       radius       ˲뾶£4.0ɡ
-                       ֵԽܵƣα
-  * أ
+  * 功能：指纹图像增强算法
+  *       该算法描述起来比较复杂，其后处理的部分是基于Gabor滤波器的，
+          参数动态计算。图像处理时参数依次改变，所以要做一个原图的备份。
+  * 参数：image        指纹图像
+  *       direction    脊线方向，需要事先计算
+  *       frequency    脊线频率，需要事先计算
+  *       mask         指示指纹的有效区域
+  *       radius       滤波器半径，大多数情况下，4.0即可。
+                       值越大，噪声可以受到更大抑制，但会产生更多的伪特征。
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageEnhanceGabor(FvsImage_t image, const FvsFloatField_t direction,
                              const FvsFloatField_t frequency, const FvsImage_t mask,
                              const FvsFloat_t radius) {
+    return ImageEnhanceGaborFilter(image, direction, frequency, mask, radius,
+                                   FvsGaborTable);
+}
+
+
+/******************************************************************************
+  * 功能：使用指定的滤波器实现进行指纹图像增强，参数同 ImageEnhanceGabor
+  * 参数：filter       FvsGaborFull      每点计算完整的Gabor核
+  *                    FvsGaborAdaptive  按邻近频率差调整核的宽度
+  *                    FvsGaborTable     高斯部分查表（默认）
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageEnhanceGaborFilter(FvsImage_t image, const FvsFloatField_t direction,
+                                   const FvsFloatField_t frequency, const FvsImage_t mask,
+                                   const FvsFloat_t radius, const FvsGaborFilter_t filter) {
     FvsError_t nRet = FvsOK;
-    FvsFloat_t * image_orientation = FloatFieldGetBuffer(direction);
-    FvsFloat_t * image_frequence   = FloatFieldGetBuffer(frequency);
+    FvsFieldFloat_t * image_orientation = FloatFieldGetBuffer(direction);
+    FvsFieldFloat_t * image_frequence   = FloatFieldGetBuffer(frequency);
+    FVS_PROFILE_BEGIN(tprof);
     if (image_orientation == NULL || image_frequence == NULL)
         return FvsMemory;
-    nRet = ImageEnhanceFilter2(image, mask, image_orientation,
-                               image_frequence, radius);
+    switch (filter) {
+        case FvsGaborFull:
+            nRet = ImageEnhanceFilter(image, mask, image_orientation,
+                                      image_frequence, radius);
+            break;
+        case FvsGaborAdaptive:
+            nRet = ImageEnhanceFilter1(image, mask, image_orientation,
+                                       image_frequence, radius);
+            break;
+        case FvsGaborTable:
+            nRet = ImageEnhanceFilter2(image, mask, image_orientation,
+                                       image_frequence, radius);
+            break;
+        default:
+            return FvsBadParameter;
+    }
+    FVS_PROFILE_END(tprof, FvsProfileEnhance, ImageGetSize(image), 0, 0);
     return nRet;
 }
 
+
+
+/******************************************************************************
+  * 功能：指纹图像增强并二值化，与先调用 ImageEnhanceGabor 再调用
+  *       ImageBinarize(image, limit) 的结果相同，但只扫描一次图像，
+  *       也不生成中间的灰度增强图像
+  * 参数：image        指纹图像，bits 为空时输出二值化图像
+  *       direction    脊线方向，需要事先计算
+  *       frequency    脊线频率，需要事先计算
+  *       mask         指示指纹的有效区域
+  *       radius       滤波器半径
+  *       limit        二值化阈值
+  *       bits         不为空时输出到1位图像，image 保持不变
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageEnhanceGaborBinarize(FvsImage_t image, const FvsFloatField_t direction,
+                                     const FvsFloatField_t frequency, const FvsImage_t mask,
+                                     const FvsFloat_t radius, const FvsByte_t limit,
+                                     FvsBitImage_t bits) {
+    FvsError_t nRet;
+    FvsFieldFloat_t * image_orientation = FloatFieldGetBuffer(direction);
+    FvsFieldFloat_t * image_frequence   = FloatFieldGetBuffer(frequency);
+    FVS_PROFILE_BEGIN(tprof);
+    if (image_orientation == NULL || image_frequence == NULL)
+        return FvsMemory;
+    nRet = ImageEnhanceFilter2Binarize(image, mask, image_orientation,
+                                       image_frequence, radius, limit, bits);
+    FVS_PROFILE_END(tprof, FvsProfileEnhance, ImageGetSize(image), 0, 0);
+    return nRet;
+}
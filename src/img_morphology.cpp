@@ -1,20 +1,21 @@
 /*#############################################################################
- * ļimg_morphology.cpp
- * ܣ  ʵҪͼ̬ѧ
+ * 文件名：img_morphology.cpp
+ * 功能：  实现了主要的图像形态学操作
 #############################################################################*/
 
 
 #include "img_base.h"
 
 #include <string.h>
+#include <stdlib.h>
 
 
 #define P(x,y)      p[(x)+(y)*pitch]
 
 /******************************************************************************
-  * ܣͼ㷨
-  * image   ָͼ
-  * أ
+  * 功能：图像膨胀算法
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageDilate(FvsImage_t image) {
     FvsInt_t w      = ImageGetWidth (image);
@@ -42,9 +43,9 @@ FvsError_t ImageDilate(FvsImage_t image) {
 
 
 /******************************************************************************
-  * ܣͼʴ㷨
-  * image   ָͼ
-  * أ
+  * 功能：图像腐蚀算法
+  * 参数：image   指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t ImageErode(FvsImage_t image) {
     FvsInt_t w      = ImageGetWidth (image);
@@ -71,4 +72,131 @@ FvsError_t ImageErode(FvsImage_t image) {
 }
 
 
+/******************************************************************************
+** 任意半径的膨胀和腐蚀
+**
+** 连续调用 n 次 ImageDilate 等价于：到某个 0xFF 象素的4邻域距离不超过 n 的
+** 象素都置为 0xFF。但是 ImageDilate 只从不在边缘上的象素向外扩展，所以这个
+** 距离是只经过非边缘象素的路径长度；边缘象素只能被到达，不能再向外扩展。
+** 非边缘象素构成一个矩形，在矩形内用正反两遍扫描即可得到准确的4邻域距离，
+** 边缘象素的距离再由相邻的非边缘象素加1得到。
+** 这样不论半径多大，都只需要扫描图像3遍。腐蚀是对 0x00 象素做同样的计算。
+******************************************************************************/
+
+/******************************************************************************
+  * 功能：计算每个象素到源象素的距离，只经过非边缘象素，超过 limit 的记为 limit
+  * 参数：p       图像
+  *       w,h     图像大小
+  *       pitch   行宽
+  *       value   源象素的值
+  *       limit   距离的上限
+  *       dist    输出的距离，w x h
+  * 返回：无
+******************************************************************************/
+static void MorphologyDistance(const FvsByte_t* p, const FvsInt_t w, const FvsInt_t h,
+                               const FvsInt_t pitch, const FvsByte_t value,
+                               const FvsInt_t limit, FvsInt_t* dist) {
+    FvsInt_t x, y, d;
+    FvsInt_t* row;
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            dist[x + y * w] = (x > 0 && x < w - 1 && y > 0 && y < h - 1 &&
+                               P(x, y) == value) ? 0 : limit;
+    /* 正向扫描：左边和上边 */
+    for (y = 1; y < h - 1; y++) {
+        row = dist + y * w;
+        for (x = 1; x < w - 1; x++) {
+            d = row[x];
+            if (x > 1 && row[x - 1] + 1 < d)
+                d = row[x - 1] + 1;
+            if (y > 1 && row[x - w] + 1 < d)
+                d = row[x - w] + 1;
+            row[x] = d;
+        }
+    }
+    /* 反向扫描：右边和下边 */
+    for (y = h - 2; y > 0; y--) {
+        row = dist + y * w;
+        for (x = w - 2; x > 0; x--) {
+            d = row[x];
+            if (x < w - 2 && row[x + 1] + 1 < d)
+                d = row[x + 1] + 1;
+            if (y < h - 2 && row[x + w] + 1 < d)
+                d = row[x + w] + 1;
+            row[x] = d;
+        }
+    }
+    /* 边缘象素：由相邻的非边缘象素得到 */
+    if (w < 3 || h < 3)
+        return;
+    for (y = 1; y < h - 1; y++) {
+        row = dist + y * w;
+        row[0]     = row[1] + 1;
+        row[w - 1] = row[w - 2] + 1;
+    }
+    for (x = 1; x < w - 1; x++) {
+        dist[x]               = dist[x + w] + 1;
+        dist[x + (h - 1) * w] = dist[x + (h - 2) * w] + 1;
+    }
+}
+
+
+/******************************************************************************
+  * 功能：按半径膨胀或腐蚀
+  * 参数：image    二值图像
+  *       radius   半径
+  *       dilate   FvsTrue 膨胀，FvsFalse 腐蚀
+  * 返回：错误编号
+******************************************************************************/
+static FvsError_t MorphologyRadius(FvsImage_t image, const FvsInt_t radius,
+                                   const FvsBool_t dilate) {
+    FvsInt_t w      = ImageGetWidth (image);
+    FvsInt_t h      = ImageGetHeight(image);
+    FvsInt_t pitch  = ImageGetPitch (image);
+    FvsByte_t* p    = ImageGetBuffer(image);
+    FvsInt_t* dist;
+    FvsInt_t x, y, d;
+    if (p == NULL)
+        return FvsMemory;
+    if (radius <= 0)
+        return FvsOK;
+    dist = (FvsInt_t*)malloc((size_t)w * h * sizeof(FvsInt_t));
+    if (dist == NULL)
+        return FvsMemory;
+    MorphologyDistance(p, w, h, pitch, (dilate == FvsTrue) ? 0xFF : 0x00,
+                       radius + 1, dist);
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++) {
+            d = dist[x + y * w];
+            if (dilate == FvsTrue)
+                P(x, y) = (d <= radius || P(x, y) != 0) ? 0xFF : 0x00;
+            else
+                P(x, y) = (d <= radius || P(x, y) != 0xFF) ? 0x00 : 0xFF;
+        }
+    free(dist);
+    return FvsOK;
+}
+
 
+/******************************************************************************
+  * 功能：按半径膨胀，结果与连续调用 radius 次 ImageDilate 相同，
+  *       但只扫描图像3遍。图像必须是二值化的（只包含0x00或0xFF）
+  * 参数：image    指纹图像
+  *       radius   半径（4邻域距离）
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageDilateRadius(FvsImage_t image, const FvsInt_t radius) {
+    return MorphologyRadius(image, radius, FvsTrue);
+}
+
+
+/******************************************************************************
+  * 功能：按半径腐蚀，结果与连续调用 radius 次 ImageErode 相同，
+  *       但只扫描图像3遍。图像必须是二值化的（只包含0x00或0xFF）
+  * 参数：image    指纹图像
+  *       radius   半径（4邻域距离）
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageErodeRadius(FvsImage_t image, const FvsInt_t radius) {
+    return MorphologyRadius(image, radius, FvsFalse);
+}
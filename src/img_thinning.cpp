@@ -0,0 +1,673 @@
+
+/*#############################################################################
+ * 文件名：img_thinning.cpp
+ * 功能：  查表实现的细化算法
+#############################################################################*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "imagemanip.h"
+#include "parallel.h"
+#include "profile.h"
+
+
+/******************************************************************************
+** 邻域点定义与 imagemanip.cpp 相同:
+**     9 2 3
+**     8 1 4
+**     7 6 5
+** 把 P2..P9 是否为0 编码为8位的索引（P2 为第0位，P9 为第7位），
+** 每种 3x3 邻域是否删除中心点预先算在256项的表中，
+** 细化时每个前景点只需要一次查表，代替逐项判断的长串分支。
+******************************************************************************/
+
+#define NB(i, n)    (((i) >> ((n) - 2)) & 1)	/* 索引中的 Pn */
+
+
+/******************************************************************************
+  * 功能：生成连通性细化两个子迭代的删除表，条件与 ImageThinConnectivity 相同
+  * 参数：step1   第一个子迭代的表
+  *       step2   第二个子迭代的表
+  * 返回：无
+******************************************************************************/
+static void ThinTableConnectivity(FvsByte_t step1[256], FvsByte_t step2[256]) {
+    FvsInt_t i, k, n, t;
+    FvsInt_t seq[9];
+    for (i = 0; i < 256; i++) {
+        /* a) 2-6个邻点 */
+        n = 0;
+        for (k = 2; k <= 9; k++)
+            n += NB(i, k);
+        /* b) 按 9,2,3,...,8,9 的顺序由0变1的次数 */
+        seq[0] = NB(i, 9);
+        for (k = 2; k <= 9; k++)
+            seq[k - 1] = NB(i, k);
+        t = 0;
+        for (k = 0; k < 8; k++)
+            if (seq[k] == 0 && seq[k + 1] != 0)
+                t++;
+        step1[i] = step2[i] = 0;
+        if (n < 2 || n > 6 || t != 1)
+            continue;
+        /* c) d) */
+        if (!(NB(i, 2) && NB(i, 4) && NB(i, 6)) && !(NB(i, 4) && NB(i, 6) && NB(i, 8)))
+            step1[i] = 1;
+        if (!(NB(i, 2) && NB(i, 6) && NB(i, 8)) && !(NB(i, 2) && NB(i, 4) && NB(i, 8)))
+            step2[i] = 1;
+    }
+}
+
+
+/******************************************************************************
+  * 功能：生成 Hit and Miss 细化的删除表，8个模板与 ImageThinHitMiss 相同
+  * 参数：table   删除表
+  * 返回：无
+******************************************************************************/
+static void ThinTableHitMiss(FvsByte_t table[256]) {
+    FvsInt_t i;
+    FvsInt_t n, ne, e, se, s, sw, wt, nw;
+    for (i = 0; i < 256; i++) {
+        n  = NB(i, 2);
+        ne = NB(i, 3);
+        e  = NB(i, 4);
+        se = NB(i, 5);
+        s  = NB(i, 6);
+        sw = NB(i, 7);
+        wt = NB(i, 8);
+        nw = NB(i, 9);
+        table[i] = (FvsByte_t)(
+                       (!nw && !n && !ne && sw && s && se) ||
+                       (nw && n && ne && !sw && !s && !se) ||
+                       (!nw && !wt && !sw && ne && e && se) ||
+                       (nw && wt && sw && !ne && !e && !se) ||
+                       (!n && !ne && !e && wt && s) ||
+                       (!nw && !n && !wt && e && s) ||
+                       (!sw && !wt && !s && e && n) ||
+                       (!se && !e && !s && wt && n));
+    }
+}
+
+
+/******************************************************************************
+  * 功能：生成去毛刺的删除表，条件与 ImageRemoveSpurs 相同
+  * 参数：table   删除表
+  * 返回：无
+******************************************************************************/
+static void ThinTableSpurs(FvsByte_t table[256]) {
+    FvsInt_t i, t;
+    for (i = 0; i < 256; i++) {
+        t = 0;
+        if (!NB(i, 3) && NB(i, 2) && !NB(i, 4)) t++;
+        if (!NB(i, 5) && NB(i, 4) && !NB(i, 6)) t++;
+        if (!NB(i, 7) && NB(i, 6) && !NB(i, 8)) t++;
+        if (!NB(i, 9) && NB(i, 8) && !NB(i, 2)) t++;
+        if (NB(i, 3) && !NB(i, 4)) t++;
+        if (NB(i, 5) && !NB(i, 6)) t++;
+        if (NB(i, 7) && !NB(i, 8)) t++;
+        if (NB(i, 9) && !NB(i, 2)) t++;
+        table[i] = (FvsByte_t)(t == 1);
+    }
+}
+
+
+/* 取 (x,y) 的邻域索引，n、c、s 为上、中、下三行 */
+#define THIN_INDEX(n, c, s, x) \
+            ( (FvsInt_t)((n)[x]   != 0)       | ((FvsInt_t)((n)[x+1] != 0) << 1) \
+            | ((FvsInt_t)((c)[x+1] != 0) << 2) | ((FvsInt_t)((s)[x+1] != 0) << 3) \
+            | ((FvsInt_t)((s)[x]   != 0) << 4) | ((FvsInt_t)((s)[x-1] != 0) << 5) \
+            | ((FvsInt_t)((c)[x-1] != 0) << 6) | ((FvsInt_t)((n)[x-1] != 0) << 7) )
+
+
+/******************************************************************************
+  * 功能：按表对所有内部点判断，先标记为0x80，全部判断完再删除。
+  *       0x80 仍为非0，所以判断时看到的都是原图，与逐项判断的实现相同。
+  * 参数：p, w, h, pitch   图像
+  *       table            删除表
+  * 返回：删除的点数
+******************************************************************************/
+static FvsInt_t ThinTableMarkAndDelete(FvsByte_t* p, const FvsInt_t w, const FvsInt_t h,
+                                       const FvsInt_t pitch, const FvsByte_t table[256]) {
+    FvsInt_t x, y, n = 0;
+    FvsByte_t *r0, *r1, *r2;
+    for (y = 1; y < h - 1; y++) {
+        r0 = p + (y - 1) * pitch;
+        r1 = r0 + pitch;
+        r2 = r1 + pitch;
+        for (x = 1; x < w - 1; x++)
+            if (r1[x] == 0xFF && table[THIN_INDEX(r0, r1, r2, x)]) {
+                r1[x] = 0x80;
+                n++;
+            }
+    }
+    if (n > 0)
+        for (y = 1; y < h - 1; y++) {
+            r1 = p + y * pitch;
+            for (x = 1; x < w - 1; x++)
+                if (r1[x] == 0x80)
+                    r1[x] = 0;
+        }
+    return n;
+}
+
+
+/******************************************************************************
+  * 功能：查表细化指纹图像，结果与 ImageThinConnectivity / ImageThinHitMiss
+  *       完全相同（包括最后的去毛刺）。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image    指纹图像
+  *       method   FvsThinConnectivity 或 FvsThinHitMiss
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinTable(FvsImage_t image, const FvsThinMethod_t method) {
+    FvsInt_t w       = ImageGetWidth(image);
+    FvsInt_t h       = ImageGetHeight(image);
+    FvsInt_t pitch   = ImageGetPitch(image);
+    FvsByte_t* p     = ImageGetBuffer(image);
+    FvsByte_t step1[256], step2[256], spurs[256];
+    FvsByte_t *r0, *r1, *r2;
+    FvsInt_t x, y, c, n;
+    FvsInt_t passes = 0;
+    FVS_PROFILE_BEGIN(tprof);
+    if (p == NULL)
+        return FvsMemory;
+    if (ImageGetFlag(image) != FvsImageBinarized)
+        return FvsBadParameter;
+    switch (method) {
+        case FvsThinConnectivity:
+            ThinTableConnectivity(step1, step2);
+            do {
+                passes++;
+                n  = ThinTableMarkAndDelete(p, w, h, pitch, step1);
+                n += ThinTableMarkAndDelete(p, w, h, pitch, step2);
+            }
+            while (n > 0);
+            break;
+        case FvsThinHitMiss:
+            /* 立即删除，后面的点看到的是已更新的左邻点和上一行 */
+            ThinTableHitMiss(step1);
+            do {
+                passes++;
+                n = 0;
+                for (y = 1; y < h - 1; y++) {
+                    r0 = p + (y - 1) * pitch;
+                    r1 = r0 + pitch;
+                    r2 = r1 + pitch;
+                    for (x = 1; x < w - 1; x++)
+                        if (r1[x] == 0xFF && step1[THIN_INDEX(r0, r1, r2, x)]) {
+                            r1[x] = 0;
+                            n++;
+                        }
+                }
+            }
+            while (n > 0);
+            break;
+        default:
+            return FvsBadParameter;
+    }
+    /* 去毛刺，最多5遍 */
+    ThinTableSpurs(spurs);
+    c = 0;
+    while (ThinTableMarkAndDelete(p, w, h, pitch, spurs) > 0 && ++c < 5)
+        ;
+    FVS_PROFILE_END(tprof, FvsProfileThinning, w * h, passes, 0);
+    return ImageSetFlag(image, FvsImageThinned);
+}
+
+
+/******************************************************************************
+** 工作表细化
+** 一个点是否删除只取决于它的 3x3 邻域，如果上次判断之后邻域没有变化，
+** 再判断的结果也不变。所以每次只需要判断删除点的邻点，
+** 总的工作量与脊线长度成正比，而不是图像面积乘以迭代次数。
+******************************************************************************/
+
+/* 可增长的点位置数组 */
+typedef struct ThinList_t {
+    FvsInt_t*  pos;
+    FvsInt_t   count;
+    FvsInt_t   size;
+} ThinList_t;
+
+
+static FvsBool_t ThinListPush(ThinList_t* list, const FvsInt_t pos) {
+    FvsInt_t* p;
+    if (list->count == list->size) {
+        FvsInt_t size = (list->size > 0) ? list->size * 2 : 1024;
+        p = (FvsInt_t*)realloc(list->pos, (size_t)size * sizeof(FvsInt_t));
+        if (p == NULL)
+            return FvsFalse;
+        list->pos  = p;
+        list->size = size;
+    }
+    list->pos[list->count++] = pos;
+    return FvsTrue;
+}
+
+
+/* 最小堆，用于按光栅顺序取出本遍要判断的点 */
+static FvsBool_t ThinHeapPush(ThinList_t* heap, const FvsInt_t pos) {
+    FvsInt_t i, parent;
+    if (ThinListPush(heap, pos) == FvsFalse)
+        return FvsFalse;
+    i = heap->count - 1;
+    while (i > 0) {
+        parent = (i - 1) >> 1;
+        if (heap->pos[parent] <= pos)
+            break;
+        heap->pos[i] = heap->pos[parent];
+        i = parent;
+    }
+    heap->pos[i] = pos;
+    return FvsTrue;
+}
+
+
+static FvsInt_t ThinHeapPop(ThinList_t* heap) {
+    FvsInt_t top = heap->pos[0];
+    FvsInt_t last = heap->pos[--heap->count];
+    FvsInt_t i = 0, child;
+    while ((child = 2 * i + 1) < heap->count) {
+        if (child + 1 < heap->count && heap->pos[child + 1] < heap->pos[child])
+            child++;
+        if (heap->pos[child] >= last)
+            break;
+        heap->pos[i] = heap->pos[child];
+        i = child;
+    }
+    if (heap->count > 0)
+        heap->pos[i] = last;
+    return top;
+}
+
+
+static int ThinCompare(const void* a, const void* b) {
+    return *(const FvsInt_t*)a - *(const FvsInt_t*)b;
+}
+
+
+/* 工作表细化的状态 */
+typedef struct ThinWork_t {
+    FvsByte_t*  p;
+    FvsInt_t    w;
+    FvsInt_t    h;
+    FvsInt_t    pitch;
+    FvsByte_t*  flags;        /* 每点所在的表：第0位 list[0]，第1位 list[1]，
+                                 第2位 heap，THIN_BORDER 为边界点 */
+    ThinList_t  list[2];
+    ThinList_t  heap;
+    ThinList_t  deleted;
+} ThinWork_t;
+
+
+#define THIN_BORDER     0x80
+
+
+/* 把 q 加入第 n 个表（去重），边界点不处理 */
+static FvsBool_t ThinWorkAdd(ThinWork_t* t, const FvsInt_t n, const FvsInt_t q) {
+    FvsByte_t bit = (FvsByte_t)(1 << n);
+    if ((t->flags[q] & (bit | THIN_BORDER)) != 0 || t->p[q] == 0)
+        return FvsTrue;
+    t->flags[q] |= bit;
+    return ThinListPush(&t->list[n], q);
+}
+
+
+/* 初始的工作表：有背景邻点的所有前景内部点 */
+static FvsBool_t ThinWorkInit(ThinWork_t* t, const FvsInt_t lists) {
+    FvsInt_t x, y, n, q;
+    FvsByte_t *r0, *r1, *r2;
+    memset(t->flags, 0, (size_t)t->pitch * t->h);
+    memset(t->flags, THIN_BORDER, (size_t)t->pitch);
+    memset(t->flags + (size_t)(t->h - 1) * t->pitch, THIN_BORDER, (size_t)t->pitch);
+    for (y = 1; y < t->h - 1; y++) {
+        t->flags[y * t->pitch] = THIN_BORDER;
+        t->flags[y * t->pitch + t->w - 1] = THIN_BORDER;
+    }
+    for (n = 0; n < 2; n++)
+        t->list[n].count = 0;
+    t->heap.count = 0;
+    for (y = 1; y < t->h - 1; y++) {
+        r0 = t->p + (y - 1) * t->pitch;
+        r1 = r0 + t->pitch;
+        r2 = r1 + t->pitch;
+        for (x = 1; x < t->w - 1; x++)
+            if (r1[x] != 0 && THIN_INDEX(r0, r1, r2, x) != 0xFF) {
+                q = x + y * t->pitch;
+                for (n = 0; n < lists; n++)
+                    if (ThinWorkAdd(t, n, q) == FvsFalse)
+                        return FvsFalse;
+            }
+    }
+    return FvsTrue;
+}
+
+
+/******************************************************************************
+  * 功能：并行删除的一步（连通性细化的子迭代、去毛刺）
+  *       判断第 n 个表中的点，统一删除，再把删除点的邻点加入各个表。
+  * 参数：t       工作状态
+  *       n       判断的表
+  *       lists   表的个数
+  *       table   删除表
+  * 返回：删除的点数，内存不足返回 -1
+******************************************************************************/
+static FvsInt_t ThinWorkStep(ThinWork_t* t, const FvsInt_t n, const FvsInt_t lists,
+                             const FvsByte_t table[256]) {
+    ThinList_t* list = &t->list[n];
+    FvsInt_t pitch = t->pitch;
+    FvsInt_t i, k, q;
+    FvsByte_t* r;
+    t->deleted.count = 0;
+    for (i = 0; i < list->count; i++) {
+        q = list->pos[i];
+        t->flags[q] &= (FvsByte_t)~(1 << n);
+        r = t->p + q;
+        if (*r == 0xFF && table[THIN_INDEX(r - pitch, r, r + pitch, 0)])
+            if (ThinListPush(&t->deleted, q) == FvsFalse)
+                return -1;
+    }
+    list->count = 0;
+    for (i = 0; i < t->deleted.count; i++)
+        t->p[t->deleted.pos[i]] = 0;
+    for (i = 0; i < t->deleted.count; i++) {
+        q = t->deleted.pos[i];
+        for (k = 0; k < lists; k++)
+            if (ThinWorkAdd(t, k, q - pitch - 1) == FvsFalse ||
+                    ThinWorkAdd(t, k, q - pitch) == FvsFalse ||
+                    ThinWorkAdd(t, k, q - pitch + 1) == FvsFalse ||
+                    ThinWorkAdd(t, k, q - 1) == FvsFalse ||
+                    ThinWorkAdd(t, k, q + 1) == FvsFalse ||
+                    ThinWorkAdd(t, k, q + pitch - 1) == FvsFalse ||
+                    ThinWorkAdd(t, k, q + pitch) == FvsFalse ||
+                    ThinWorkAdd(t, k, q + pitch + 1) == FvsFalse)
+                return -1;
+    }
+    return t->deleted.count;
+}
+
+
+/******************************************************************************
+  * 功能：Hit and Miss 的一遍扫描。
+  *       list[0] 是本遍已排序的点，与 heap 合并后按光栅顺序取点并立即删除；
+  *       删除点后面的邻点本遍还没扫到，加入本遍的 heap，
+  *       前面的邻点本遍已经扫过，加入下一遍的 list[1]。
+  * 参数：t       工作状态
+  *       table   删除表
+  * 返回：删除的点数，内存不足返回 -1
+******************************************************************************/
+static FvsInt_t ThinWorkHitMissPass(ThinWork_t* t, const FvsByte_t table[256]) {
+    FvsInt_t pitch = t->pitch;
+    FvsInt_t n = 0, i = 0, q;
+    FvsByte_t* r;
+    for (;;) {
+        if (t->heap.count > 0 && (i == t->list[0].count || t->heap.pos[0] < t->list[0].pos[i])) {
+            q = ThinHeapPop(&t->heap);
+            t->flags[q] &= (FvsByte_t)~4;
+        }
+        else if (i < t->list[0].count) {
+            q = t->list[0].pos[i++];
+            t->flags[q] &= (FvsByte_t)~1;
+        }
+        else
+            break;
+        r = t->p + q;
+        if (*r != 0xFF || !table[THIN_INDEX(r - pitch, r, r + pitch, 0)])
+            continue;
+        *r = 0;
+        n++;
+        /* 后面的邻点：本遍。已在 list[0] 中的点还没取到，不用重复加入 */
+#define THIN_NOW(q2) \
+            if (t->p[q2] != 0 && (t->flags[q2] & (1 | 4 | THIN_BORDER)) == 0) { \
+                t->flags[q2] |= 4; \
+                if (ThinHeapPush(&t->heap, q2) == FvsFalse) return -1; \
+            }
+        THIN_NOW(q + 1);
+        THIN_NOW(q + pitch - 1);
+        THIN_NOW(q + pitch);
+        THIN_NOW(q + pitch + 1);
+#undef THIN_NOW
+        /* 前面的邻点：下一遍 */
+        if (ThinWorkAdd(t, 1, q - pitch - 1) == FvsFalse ||
+                ThinWorkAdd(t, 1, q - pitch) == FvsFalse ||
+                ThinWorkAdd(t, 1, q - pitch + 1) == FvsFalse ||
+                ThinWorkAdd(t, 1, q - 1) == FvsFalse)
+            return -1;
+    }
+    t->list[0].count = 0;
+    return n;
+}
+
+
+/******************************************************************************
+  * 功能：工作表细化指纹图像，只重新判断删除点的邻点。
+  *       结果与 ImageThinConnectivity / ImageThinHitMiss 完全相同（包括去毛刺）。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image    指纹图像
+  *       method   细化算法
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinWorkList(FvsImage_t image, const FvsThinMethod_t method) {
+    ThinWork_t t;
+    FvsByte_t step1[256], step2[256];
+    FvsInt_t n, m, c;
+    FvsInt_t passes = 0;
+    FvsError_t nRet = FvsOK;
+    FVS_PROFILE_BEGIN(tprof);
+    memset(&t, 0, sizeof(t));
+    t.p     = ImageGetBuffer(image);
+    t.w     = ImageGetWidth(image);
+    t.h     = ImageGetHeight(image);
+    t.pitch = ImageGetPitch(image);
+    if (t.p == NULL)
+        return FvsMemory;
+    if (ImageGetFlag(image) != FvsImageBinarized)
+        return FvsBadParameter;
+    if (method != FvsThinConnectivity && method != FvsThinHitMiss)
+        return FvsBadParameter;
+    if (t.w < 3 || t.h < 3)
+        return ImageSetFlag(image, FvsImageThinned);
+    t.flags = (FvsByte_t*)malloc((size_t)t.pitch * t.h);
+    if (t.flags == NULL)
+        return FvsMemory;
+    if (method == FvsThinConnectivity) {
+        ThinTableConnectivity(step1, step2);
+        if (ThinWorkInit(&t, 2) == FvsFalse)
+            nRet = FvsMemory;
+        while (nRet == FvsOK) {
+            passes++;
+            n = ThinWorkStep(&t, 0, 2, step1);
+            m = (n < 0) ? -1 : ThinWorkStep(&t, 1, 2, step2);
+            if (n < 0 || m < 0)
+                nRet = FvsMemory;
+            else if (n + m == 0)
+                break;
+        }
+    }
+    else {
+        ThinTableHitMiss(step1);
+        /* 初始的表按光栅顺序加入，已经排好序 */
+        if (ThinWorkInit(&t, 1) == FvsFalse)
+            nRet = FvsMemory;
+        while (nRet == FvsOK) {
+            passes++;
+            n = ThinWorkHitMissPass(&t, step1);
+            if (n < 0) {
+                nRet = FvsMemory;
+                break;
+            }
+            if (n == 0)
+                break;
+            /* 下一遍的表排序后作为 list[0]，空表的 pos 可能为空 */
+            if (t.list[1].count > 1)
+                qsort(t.list[1].pos, t.list[1].count, sizeof(FvsInt_t), ThinCompare);
+            for (m = 0; m < t.list[1].count; m++)
+                t.flags[t.list[1].pos[m]] ^= 1 | 2;
+            {
+                ThinList_t tmp = t.list[0];
+                t.list[0] = t.list[1];
+                t.list[1] = tmp;
+            }
+        }
+    }
+    /* 去毛刺：只重新判断删除点的邻点，最多5遍 */
+    if (nRet == FvsOK) {
+        ThinTableSpurs(step1);
+        if (ThinWorkInit(&t, 1) == FvsFalse)
+            nRet = FvsMemory;
+        c = 0;
+        while (nRet == FvsOK) {
+            n = ThinWorkStep(&t, 0, 1, step1);
+            if (n < 0)
+                nRet = FvsMemory;
+            else if (n == 0 || ++c >= 5)
+                break;
+        }
+    }
+    free(t.list[0].pos);
+    free(t.list[1].pos);
+    free(t.heap.pos);
+    free(t.deleted.pos);
+    free(t.flags);
+    if (nRet != FvsOK)
+        return nRet;
+    FVS_PROFILE_END(tprof, FvsProfileThinning, t.w * t.h, passes, 0);
+    return ImageSetFlag(image, FvsImageThinned);
+}
+
+
+/******************************************************************************
+** 分带并行细化
+** 图像按行分成若干带，每个子迭代分两步：各带并行判断（读本带和上下各一行），
+** 把要删除的点记在本带的表中；全部判断完后各带再并行删除本带的点。
+** 判断时看到的都是子迭代开始时的图像，结果与 ImageThinConnectivity 完全相同，
+** 与线程数和带数无关。
+******************************************************************************/
+
+/* 一个带 */
+typedef struct ThinBand_t {
+    FvsInt_t    y0, y1;       /* 行 y0..y1-1 */
+    ThinList_t  deleted;
+    FvsBool_t   failed;
+} ThinBand_t;
+
+
+typedef struct ThinBands_t {
+    FvsByte_t*        p;
+    FvsInt_t          w;
+    FvsInt_t          pitch;
+    const FvsByte_t*  table;
+    ThinBand_t*       bands;
+} ThinBands_t;
+
+
+static void ThinBandMark(const FvsInt_t index, FvsPointer_t context) {
+    ThinBands_t* t = (ThinBands_t*)context;
+    ThinBand_t* band = t->bands + index;
+    FvsInt_t x, y;
+    FvsByte_t *r0, *r1, *r2;
+    band->deleted.count = 0;
+    for (y = band->y0; y < band->y1; y++) {
+        r0 = t->p + (y - 1) * t->pitch;
+        r1 = r0 + t->pitch;
+        r2 = r1 + t->pitch;
+        for (x = 1; x < t->w - 1; x++)
+            if (r1[x] == 0xFF && t->table[THIN_INDEX(r0, r1, r2, x)])
+                if (ThinListPush(&band->deleted, x + y * t->pitch) == FvsFalse) {
+                    band->failed = FvsTrue;
+                    return;
+                }
+    }
+}
+
+
+static void ThinBandDelete(const FvsInt_t index, FvsPointer_t context) {
+    ThinBands_t* t = (ThinBands_t*)context;
+    ThinBand_t* band = t->bands + index;
+    FvsInt_t i;
+    for (i = 0; i < band->deleted.count; i++)
+        t->p[band->deleted.pos[i]] = 0;
+}
+
+
+/* 一个子迭代，返回删除的点数，内存不足返回 -1 */
+static FvsInt_t ThinBandStep(ThinBands_t* t, const FvsInt_t count, const FvsByte_t table[256]) {
+    FvsInt_t i, n = 0;
+    t->table = table;
+    ParallelFor(count, ThinBandMark, t);
+    for (i = 0; i < count; i++) {
+        if (t->bands[i].failed == FvsTrue)
+            return -1;
+        n += t->bands[i].deleted.count;
+    }
+    if (n > 0)
+        ParallelFor(count, ThinBandDelete, t);
+    return n;
+}
+
+
+/******************************************************************************
+  * 功能：多线程细化指纹图像，结果与 ImageThinConnectivity 完全相同。
+  *       线程数由 ParallelSetThreadCount 设置。
+  *       图像必须是二值化过的（只包含0x00或oxFF）
+  * 参数：image   指纹图像
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ImageThinConnectivityParallel(FvsImage_t image) {
+    ThinBands_t t;
+    FvsByte_t step1[256], step2[256], spurs[256];
+    FvsInt_t h = ImageGetHeight(image);
+    FvsInt_t count, i, n, m, c;
+    FvsInt_t passes = 0;
+    FvsError_t nRet = FvsOK;
+    FVS_PROFILE_BEGIN(tprof);
+    t.p     = ImageGetBuffer(image);
+    t.w     = ImageGetWidth(image);
+    t.pitch = ImageGetPitch(image);
+    if (t.p == NULL)
+        return FvsMemory;
+    if (ImageGetFlag(image) != FvsImageBinarized)
+        return FvsBadParameter;
+    if (t.w < 3 || h < 3)
+        return ImageSetFlag(image, FvsImageThinned);
+    /* 每个线程几个带，以平衡各带的工作量；每带至少16行 */
+    count = ParallelGetThreadCount() * 4;
+    if (count > (h - 2) / 16)
+        count = (h - 2) / 16;
+    if (count < 1)
+        count = 1;
+    t.bands = (ThinBand_t*)malloc(count * sizeof(ThinBand_t));
+    if (t.bands == NULL)
+        return FvsMemory;
+    memset(t.bands, 0, count * sizeof(ThinBand_t));
+    for (i = 0; i < count; i++) {
+        t.bands[i].y0 = 1 + (h - 2) * i / count;
+        t.bands[i].y1 = 1 + (h - 2) * (i + 1) / count;
+    }
+    ThinTableConnectivity(step1, step2);
+    ThinTableSpurs(spurs);
+    do {
+        passes++;
+        n = ThinBandStep(&t, count, step1);
+        m = (n < 0) ? -1 : ThinBandStep(&t, count, step2);
+        if (n < 0 || m < 0)
+            nRet = FvsMemory;
+    }
+    while (nRet == FvsOK && n + m > 0);
+    /* 去毛刺，最多5遍 */
+    c = 0;
+    while (nRet == FvsOK) {
+        n = ThinBandStep(&t, count, spurs);
+        if (n < 0)
+            nRet = FvsMemory;
+        else if (n == 0 || ++c >= 5)
+            break;
+    }
+    for (i = 0; i < count; i++)
+        free(t.bands[i].deleted.pos);
+    free(t.bands);
+    if (nRet != FvsOK)
+        return nRet;
+    FVS_PROFILE_END(tprof, FvsProfileThinning, t.w * h, passes, 0);
+    return ImageSetFlag(image, FvsImageThinned);
+}
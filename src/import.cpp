@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļimport.cpp
- * ܣ  һЩͼ
+ * 文件名：import.cpp
+ * 功能：  一些基本的图像操作
 #############################################################################*/
 
 
@@ -11,10 +11,10 @@
 
 
 /******************************************************************************
-  * ܣļмָͼ
-  * image       ָͼ
-  *       filename    ļ
-  * أ
+  * 功能：从文件中加载指纹图像
+  * 参数：image       指纹图像
+  *       filename    文件名
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t FvsImageImport(FvsImage_t image, const FvsString_t filename,
                           FvsByte_t bmfh[14], BITMAPINFOHEADER *bmih, RGBQUAD *rgbq) {
@@ -48,13 +48,13 @@ FvsError_t FvsImageImport(FvsImage_t image, const FvsString_t filename,
     else {
         ret = ImageSetSize(image, (FvsInt_t)bmih->biWidth, (FvsInt_t)bmih->biHeight);
         if (ret == FvsOK) {
-            /* û */
+            /* 获得缓冲区 */
             buffer = ImageGetBuffer(image);
             pitch  = ImageGetPitch(image);
             height = ImageGetHeight(image);
             width  = ImageGetWidth(image);
             x = *(FvsDword_t*)(bmfh + 10);
-            /*  */
+            /* 拷贝数据 */
             for (i = 0; i < height; i++) {
                 y = (height - 1 - i) * WIDTHBYTES(width * 8);
                 FileSeek(file, x + y);
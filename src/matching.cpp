@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļmatching.cpp
- * ܣ  ʵָƥ㷨
+ * 文件名：matching.cpp
+ * 功能：  实现了指纹匹配算法
 #############################################################################*/
 
 #include <math.h>
@@ -9,7 +9,10 @@
 #include <stdio.h>
 #include <time.h>
 
+#include <atomic>
+
 #include "matching.h"
+#include "parallel.h"
 
 #define REF_X (FvsInt_t) 0
 #define REF_Y (FvsInt_t) 0
@@ -18,11 +21,11 @@
 
 
 typedef struct Fvs_PolarMinutia_t {
-    /* rλ */
+    /* r位置 */
     FvsFloat_t    r;
-    /* eλ */
+    /* e位置 */
     FvsFloat_t    e;
-    /* Ƕ  */
+    /* 角度  */
     FvsFloat_t    angle;
 
 } Fvs_PolarMinutia_t;
@@ -31,19 +34,12 @@ FvsError_t Insertion_Sort(Fvs_PolarMinutia_t*, FvsInt_t) ;
 FvsError_t fInsertion_Sort(FvsFloat_t* v, FvsInt_t v_length);
 
 
-Fvs_PolarMinutia_t p_polar_input[100];
-Fvs_PolarMinutia_t p_polar_tmplt[100];
-
-Fvs_PolarMinutia_t s_polar_input[100];
-Fvs_PolarMinutia_t s_polar_tmplt[100];
-
-
 /******************************************************************************
-  * ܣƥָ
-  * image1      ָͼ1
-  *       image2      ָͼ2
-  *       pgoodness   ƥȣԽԽ
-  * أ
+  * 功能：匹配两个指纹
+  * 参数：image1      指纹图像1
+  *       image2      指纹图像2
+  *       pgoodness   匹配度，越高越好
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MatchingCompareImages
 (
@@ -51,7 +47,7 @@ FvsError_t MatchingCompareImages
     const FvsImage_t image2,
     FvsInt_t* pgoodness
 ) {
-    /* 㷨δʵ֣߿Լʵ֣ */
+    /* ！！该算法尚未实现，读者可以自己试着实现！！ */
     return FvsOK;
 }
 
@@ -74,11 +70,12 @@ FvsError_t MatchingCompareImages
 
 
 /******************************************************************************
-  * ܣƥָϸڵ
-  * minutia1      ϸڵ㼯1
-  *       minutia2      ϸڵ㼯2
-  *       pgoodness   ƥȣԽԽ
-  * أ
+  * 功能：匹配指纹细节点
+  * 参数：minutia1      细节点集合1
+  *       minutia2      细节点集合2
+  *       pgoodness   匹配度，越高越好，为匹配的细节点对占较小集合的
+  *                   百分比，超过70可以认为是同一指纹
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MatchingCompareMinutiaSets (
     const FvsMinutiaSet_t set1,
@@ -97,7 +94,12 @@ FvsError_t MatchingCompareMinutiaSets (
     FvsFloat_t fatmp1[MM];
     FvsFloat_t fatmp2[MM];
     FvsFloat_t edit_dist[MM][MM];
-    // ֮
+    /* 放在栈上，使函数可重入，可在多个线程中同时匹配 */
+    Fvs_PolarMinutia_t p_polar_input[MM];
+    Fvs_PolarMinutia_t p_polar_tmplt[MM];
+    Fvs_PolarMinutia_t s_polar_input[MM];
+    Fvs_PolarMinutia_t s_polar_tmplt[MM];
+    // 距离计算之用
     FvsFloat_t diff_r, diff_e, diff_theta, ftmp;
     FvsFloat_t window_mn, a;
     FvsFloat_t edit_dist_m1_n;
@@ -116,8 +118,11 @@ FvsError_t MatchingCompareMinutiaSets (
         return FvsMemory;
     if (tmplt_minutia == NULL)
         return FvsMemory;
-    printf("\nNumber of minutiae in the input image is = %d", nb_input_minutia);
-    printf("\nNumber of minutiae in the tmplt image is = %d", nb_tmplt_minutia);
+    /* 编辑距离表只有 MM x MM */
+    if (nb_input_minutia > MM - 1)
+        nb_input_minutia = MM - 1;
+    if (nb_tmplt_minutia > MM - 1)
+        nb_tmplt_minutia = MM - 1;
     for (n = 0; n < nb_input_minutia; n++) {
         ix = (FvsInt_t)input_minutia[n].x;
         iy = (FvsInt_t)input_minutia[n].y;
@@ -142,7 +147,7 @@ FvsError_t MatchingCompareMinutiaSets (
         p_polar_tmplt[n].e = (FvsFloat_t) atan (ftmp2 / ftmp1);
         p_polar_tmplt[n].angle = (ttheta - REF_THETA);
     }
-    /* ϸڵ */
+    /* 升序排列细节点 */
     for (n = 0; n < nb_input_minutia; n++) {
         s_polar_input[n].r = p_polar_input[n].r;
         s_polar_input[n].e = p_polar_input[n].e;
@@ -151,7 +156,7 @@ FvsError_t MatchingCompareMinutiaSets (
         fatmp2[n] = fatmp1[n];
     }
     Insertion_Sort (&s_polar_input[0], nb_input_minutia);
-    for (n = 0; n < nb_input_minutia; n++) {
+    for (n = 0; n < nb_tmplt_minutia; n++) {
         s_polar_tmplt[n].r = p_polar_tmplt[n].r;
         s_polar_tmplt[n].e = p_polar_tmplt[n].e;
         s_polar_tmplt[n].angle = p_polar_tmplt[n].angle;
@@ -159,23 +164,24 @@ FvsError_t MatchingCompareMinutiaSets (
         fatmp2[n] = fatmp1[n];
     }
     Insertion_Sort (&s_polar_tmplt[0], nb_tmplt_minutia);
-    //   m = 0  n = 0edit ditance = 0
-    for (m = 0; m < nb_tmplt_minutia; m++)
+    //  如果 m = 0 或 n = 0，则edit ditance = 0
+    for (m = 0; m <= nb_tmplt_minutia; m++)
         edit_dist[m][0] = 0.0;
-    for (n = 0; n < nb_input_minutia; n++)
+    for (n = 0; n <= nb_input_minutia; n++)
         edit_dist[0][n] = 0.0;
+    // edit_dist[m][n] 对应第 m-1 个模板细节点和第 n-1 个输入细节点
     for (m = 1; m <= nb_tmplt_minutia; m++) {
-        tr = s_polar_tmplt[m].r;
-        te = s_polar_tmplt[m].e;
-        ttheta = s_polar_tmplt[m].angle;
+        tr = s_polar_tmplt[m - 1].r;
+        te = s_polar_tmplt[m - 1].e;
+        ttheta = s_polar_tmplt[m - 1].angle;
         for (n = 1; n <= nb_input_minutia; n++) {
-            ir = s_polar_input[n].r;
-            ie = s_polar_input[n].e;
-            itheta = s_polar_input[n].angle;
-            // 㴰ں w(m,n)
-            // 1.  r
+            ir = s_polar_input[n - 1].r;
+            ie = s_polar_input[n - 1].e;
+            itheta = s_polar_input[n - 1].angle;
+            // 计算窗口函数 w(m,n)
+            // 1. 计算差分 r
             diff_r = tr - ir;
-            // 2.  e
+            // 2. 计算差分 e
             ftmp = te - ie;
             ftmp += 360.0;
             // a = (ie - te + 360) mod 360
@@ -191,7 +197,7 @@ FvsError_t MatchingCompareMinutiaSets (
             else {
                 diff_e = a - 180.0;
             }
-            // 3.  theta
+            // 3. 计算差分 theta
             ftmp = ttheta - itheta;
             ftmp += 360.0;
             // a = (itheta - ttheta + 360) mod 360
@@ -207,7 +213,7 @@ FvsError_t MatchingCompareMinutiaSets (
             else {
                 diff_theta = a - 180.0;
             }
-            // 㴰ں w(m,n)
+            // 计算窗口函数 w(m,n)
             window_flag = 0;
             if((diff_r < DEL_REF) | (diff_e < SI_REF) | \
                     (diff_theta < EPS_REF)) {
@@ -222,7 +228,7 @@ FvsError_t MatchingCompareMinutiaSets (
                 window_mn = OHM;                    // w(m,n)
             }
             //=========================
-            //  edit distance:
+            // 计算 edit distance:
             //=========================
             // edit_dist[m][n] = ?
             //=========================
@@ -239,25 +245,21 @@ FvsError_t MatchingCompareMinutiaSets (
             edit_dist[m][n] = edit_dist_m_n;
         }
     }
+    nb_minutiae = nb_tmplt_minutia;
+    if (nb_input_minutia < nb_tmplt_minutia)
+        nb_minutiae = nb_input_minutia;
+    /* 对角线只在两个集合都有的范围内计算过 */
     nb_pair = 0;
-    for (m = 1; m <= nb_tmplt_minutia; m++) {
+    for (m = 1; m <= nb_minutiae; m++) {
         if (edit_dist[m][m] < (float) EDIT_DIST_THRESHOLD)
             nb_pair++;
     }
-    nb_minutiae = nb_tmplt_minutia;
-    if (nb_input_minutia < nb_tmplt_minutia)
-        nb_minutiae = nb_input_minutia;
-    Mpq = ((float)100.0 * (float)nb_pair) / (float)nb_minutiae;
-    if (Mpq > 70.0)// 70%ϸڵƥ
-        printf ("\nTemplated matched with input");
-    else
-        printf ("\nTemplated not matched with input");
+    Mpq = (nb_minutiae > 0) ? ((float)100.0 * (float)nb_pair) / (float)nb_minutiae : (float)0.0;
     *pgoodness = Mpq;
-    printf ("\nmatching application !!!\n\n\n\n");
     return FvsOK;
 }
 
-/*  */
+/* 插入排序函数 */
 FvsError_t Insertion_Sort (
     Fvs_PolarMinutia_t* v,
     FvsInt_t v_length
@@ -293,3 +295,57 @@ FvsError_t Insertion_Sort (
     return FvsOK;
 }
 
+
+/* 两两匹配时共用的数据 */
+typedef struct MatchingMany_t {
+    const FvsMinutiaSet_t*  sets;
+    FvsInt_t                count;
+    FvsInt_t*               scores;
+    FvsMatchingProgress_t   progress;
+    FvsPointer_t            context;
+    std::atomic<bool>       cancelled;
+} MatchingMany_t;
+
+
+/* 匹配第 row 行 */
+static void MatchingManyRow(const FvsInt_t row, FvsPointer_t context) {
+    MatchingMany_t* m = (MatchingMany_t*)context;
+    FvsInt_t j, goodness;
+    for (j = 0; j < m->count; j++) {
+        m->scores[row * m->count + j] = -1;
+        if (j == row || m->cancelled)
+            continue;
+        if (MinutiaSetGetCount(m->sets[row]) == 0 || MinutiaSetGetCount(m->sets[j]) == 0)
+            continue;
+        if (MatchingCompareMinutiaSets(m->sets[row], m->sets[j], &goodness) == FvsOK)
+            m->scores[row * m->count + j] = goodness;
+    }
+    if (m->progress != NULL && m->progress(row, m->context) == FvsFalse)
+        m->cancelled = true;
+}
+
+
+/******************************************************************************
+  * 功能：两两匹配一组细节点集合
+  * 参数：sets      细节点集合
+  *       count     集合个数
+  *       scores    保存结果，count * count 个
+  *       progress  每行完成后调用，可以为空
+  *       context   传给 progress 的参数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t MatchingCompareMany(const FvsMinutiaSet_t* sets, const FvsInt_t count,
+                               FvsInt_t* scores, FvsMatchingProgress_t progress,
+                               FvsPointer_t context) {
+    MatchingMany_t m;
+    if (sets == NULL || scores == NULL || count < 0)
+        return FvsBadParameter;
+    m.sets      = sets;
+    m.count     = count;
+    m.scores    = scores;
+    m.progress  = progress;
+    m.context   = context;
+    m.cancelled = false;
+    ParallelFor(count, MatchingManyRow, &m);
+    return m.cancelled ? FvsFailure : FvsOK;
+}
@@ -1,6 +1,6 @@
 /*#############################################################################
- * ļmatching.h
- * ܣ  ʵָƥ㷨
+ * 文件名：matching.h
+ * 功能：  实现了指纹匹配算法
  * modified by  PRTsinghua@hotmail.com
 #############################################################################*/
 
@@ -12,11 +12,11 @@
 
 
 /******************************************************************************
-  * ܣƥָ
-  * image1      ָͼ1
-  *       image2      ָͼ2
-  *       pgoodness   ƥȣԽԽ
-  * أ
+  * 功能：匹配两个指纹
+  * 参数：image1      指纹图像1
+  *       image2      指纹图像2
+  *       pgoodness   匹配度，越高越好
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MatchingCompareImages(const FvsImage_t image1,
                                  const FvsImage_t image2,
@@ -24,16 +24,43 @@ FvsError_t MatchingCompareImages(const FvsImage_t image1,
 
 
 /******************************************************************************
-  * ܣƥָϸڵ
-  * minutia1      ϸڵ㼯1
-  *       minutia2      ϸڵ㼯2
-  *       pgoodness   ƥȣԽԽ
-  * أ
+  * 功能：匹配指纹细节点
+  * 参数：minutia1      细节点集合1
+  *       minutia2      细节点集合2
+  *       pgoodness   匹配度，越高越好，为匹配的细节点对占较小集合的
+  *                   百分比，超过70可以认为是同一指纹
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MatchingCompareMinutiaSets(const FvsMinutiaSet_t minutia1,
                                       const FvsMinutiaSet_t minutia2,
                                       FvsInt_t* pgoodness);
 
 
+/******************************************************************************
+  * 功能：两两匹配一组细节点集合时，每完成一行调用的回调，
+  *       可能在多个线程中同时调用
+  * 参数：row      完成的行
+  *       context  调用者的参数
+  * 返回：返回false时不再开始新的匹配
+******************************************************************************/
+typedef FvsBool_t (*FvsMatchingProgress_t)(const FvsInt_t row, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：两两匹配一组细节点集合，scores[i * count + j] 为集合 i 与 j 的匹配度。
+  *       对角线、空集合和取消后没有匹配的位置为 -1。
+  *       每一行是一个并行任务，线程数由 ParallelSetThreadCount 设置。
+  * 参数：sets      细节点集合
+  *       count     集合个数
+  *       scores    保存结果，count * count 个
+  *       progress  每行完成后调用，可以为空
+  *       context   传给 progress 的参数
+  * 返回：错误编号，被取消时返回 FvsFailure
+******************************************************************************/
+FvsError_t MatchingCompareMany(const FvsMinutiaSet_t* sets, const FvsInt_t count,
+                               FvsInt_t* scores, FvsMatchingProgress_t progress,
+                               FvsPointer_t context);
+
+
 #endif /* __MATCHING_HEADER__INCLUDED__ */
 
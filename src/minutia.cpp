@@ -1,7 +1,7 @@
 
 /*#############################################################################
- * ļminutia.cpp
- * ܣ  ϸڵһЩӿ
+ * 文件名：minutia.cpp
+ * 功能：  细节点的一些函数接口
 #############################################################################*/
 
 #include <string.h>
@@ -10,6 +10,7 @@
 #include <stdio.h>
 
 #include "minutia.h"
+#include "profile.h"
 
 
 typedef struct iFvsMinutiaSet_t {
@@ -20,16 +21,16 @@ typedef struct iFvsMinutiaSet_t {
 
 
 /******************************************************************************
-  * ܣһϸڵ㼯
-  * size  ϵĴС
-  * أʧܣؿգ򷵻µĶ
+  * 功能：创建一个细节点集合
+  * 参数：size  集合的大小
+  * 返回：若失败，返回空；否则返回新的对象句柄
 ******************************************************************************/
 FvsMinutiaSet_t MinutiaSetCreate(const FvsInt_t size) {
     iFvsMinutiaSet_t* p = NULL;
     p = (iFvsMinutiaSet_t*)malloc(sizeof(iFvsMinutiaSet_t)
                                   + size * sizeof(FvsMinutia_t));
     if (p != NULL) {
-        /* ϸڵ */
+        /* 表中无细节点 */
         p->nbminutia = 0;
         p->tablesize = size;
     }
@@ -38,10 +39,10 @@ FvsMinutiaSet_t MinutiaSetCreate(const FvsInt_t size) {
 
 
 /******************************************************************************
-  * ܣϸڵ㼯ϡ
-  *       һ٣öٿΪκκãֱ롣
-  * minutia      ϸڵ㼯
-  * أ
+  * 功能：销毁细节点集合。
+  *       一旦销毁，该对象不再可以为任何函数所用，直到重新申请。
+  * 参数：minutia      细节点集合
+  * 返回：无
 ******************************************************************************/
 void MinutiaSetDestroy(FvsMinutiaSet_t minutia) {
     iFvsMinutiaSet_t* p = NULL;
@@ -53,9 +54,9 @@ void MinutiaSetDestroy(FvsMinutiaSet_t minutia) {
 
 
 /******************************************************************************
-  * ܣϸڵ㼯ϵĴС
-  * minutia      ϸڵ㼯
-  * أϸڵ㼯ϴС
+  * 功能：获得细节点集合的大小
+  * 参数：minutia      细节点集合
+  * 返回：细节点集合大小
 ******************************************************************************/
 FvsInt_t MinutiaSetGetSize(const FvsMinutiaSet_t min) {
     const iFvsMinutiaSet_t* minutia = (iFvsMinutiaSet_t*)min;
@@ -67,9 +68,9 @@ FvsInt_t MinutiaSetGetSize(const FvsMinutiaSet_t min) {
 
 
 /******************************************************************************
-  * ܣϸڵ㼯ϵʵԪظ
-  * minutia      ϸڵ㼯
-  * أԪظ
+  * 功能：细节点集合的实际元素个数
+  * 参数：minutia      细节点集合
+  * 返回：元素个数
 ******************************************************************************/
 FvsInt_t MinutiaSetGetCount(const FvsMinutiaSet_t min) {
     const iFvsMinutiaSet_t* minutia = (iFvsMinutiaSet_t*)min;
@@ -81,9 +82,9 @@ FvsInt_t MinutiaSetGetCount(const FvsMinutiaSet_t min) {
 
 
 /******************************************************************************
-  * ܣϸڵ㼯ϵݻָ
-  * minutia      ϸڵ㼯
-  * أָ
+  * 功能：返回细节点集合的数据缓冲区指针
+  * 参数：minutia      细节点集合
+  * 返回：指针
 ******************************************************************************/
 FvsMinutia_t* MinutiaSetGetBuffer(FvsMinutiaSet_t min) {
     iFvsMinutiaSet_t* minutia = (iFvsMinutiaSet_t*)min;
@@ -95,9 +96,9 @@ FvsMinutia_t* MinutiaSetGetBuffer(FvsMinutiaSet_t min) {
 
 
 /******************************************************************************
-  * ܣϸڵ㼯
-  * minutia      ϸڵ㼯
-  * أ
+  * 功能：清空细节点集合
+  * 参数：minutia      细节点集合
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MinutiaSetEmpty(FvsMinutiaSet_t min) {
     iFvsMinutiaSet_t* minutia = (iFvsMinutiaSet_t*)min;
@@ -111,13 +112,13 @@ FvsError_t MinutiaSetEmpty(FvsMinutiaSet_t min) {
 
 
 /******************************************************************************
-  * ܣڼһϸڵ㣬ˣһ
-  * minutia      ϸڵ㼯
-  *       x            ϸڵX
-  *       y            ϸڵY
-  *       type         ϸڵ
-  *       angle        Ƕ
-  * أ
+  * 功能：在集合中添加一个细节点，如果满了，返回一个错误
+  * 参数：minutia      细节点集合
+  *       x            细节点的X坐标
+  *       y            细节点的Y坐标
+  *       type         细节点类型
+  *       angle        角度
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MinutiaSetAdd(FvsMinutiaSet_t min,
                          const FvsFloat_t x, const FvsFloat_t y,
@@ -132,7 +133,7 @@ FvsError_t MinutiaSetAdd(FvsMinutiaSet_t min,
         minutia->nbminutia++;
     }
     else {
-        /* ޿ռ */
+        /* 表中无空间 */
         nRet = FvsMemory;
         fprintf(stdout, "no space!\n");
     }
@@ -150,13 +151,13 @@ static FvsError_t MinutiaSetCheckClean(FvsMinutiaSet_t min) {
     ty = 4.0;
     ta = 0.5;
     if (minutia != NULL && minutia->nbminutia > 1) {
-        /* Ƿиϸڵ */
+        /* 检验表中是否已有该细节点 */
         for (j = 0;   j < minutia->nbminutia; j++)
             for (i = j + 1; i < minutia->nbminutia; i++) {
                 mi = minutia->ptable + i;
                 mj = minutia->ptable + j;
-                /* Ƚϸڵij */
-                /*  1: Ƶϸڵ˴˿ -> ɾһ */
+                /* 比较细节点i，j */
+                /* 规则 1: 相似的细节点彼此靠近 -> 删除一个 */
                 if ( (fabs(mi->x     - mj->x    ) < tx) &&
                         (fabs(mi->y     - mj->y    ) < ty) &&
                         (fabs(mi->angle - mj->angle) < ta)
@@ -164,11 +165,11 @@ static FvsError_t MinutiaSetCheckClean(FvsMinutiaSet_t min) {
                     minutia->nbminutia--;
                     *mi = minutia->ptable[minutia->nbminutia];
                 }
-                /*  2: ෴뿿 -> ͬʱɾ */
+                /* 规则 2: 方向相反，距离靠近 -> 同时删除 */
             }
     }
     else
-        /* ޿ռ */
+        /* 表中无空间 */
         nRet = FvsMemory;
     return nRet;
 }
@@ -178,10 +179,10 @@ static FvsError_t MinutiaSetCheckClean(FvsMinutiaSet_t min) {
 
 
 /******************************************************************************
-  * ܣͼлϸڵ㣬ı䱳
-  * minutia      ϸڵ㼯
-  *       image        ָͼ
-  * أ
+  * 功能：在图像中画出细节点，不改变背景
+  * 参数：minutia      细节点集合
+  *       image        指纹图像
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MinutiaSetDraw(const FvsMinutiaSet_t min, FvsImage_t image) {
     FvsInt_t w       = ImageGetWidth(image);
@@ -195,7 +196,7 @@ FvsError_t MinutiaSetDraw(const FvsMinutiaSet_t min, FvsImage_t image) {
     fprintf(stdout, "%d\n", nbminutia);
     if (minutia == NULL || p == NULL)
         return FvsMemory;
-    /* ÿϸڵ */
+    /* 画出每个细节点 */
     for (n = 0; n < nbminutia; n++) {
         x = (FvsInt_t)minutia[n].x;
         y = (FvsInt_t)minutia[n].y;
@@ -233,7 +234,7 @@ FvsError_t MinutiaSetDraw(const FvsMinutiaSet_t min, FvsImage_t image) {
 }
 
 
-/* 궨 */
+/* 宏定义 */
 #define P1  P(x  ,y-1)
 #define P2  P(x+1,y-1)
 #define P3  P(x+1,y  )
@@ -245,13 +246,13 @@ FvsError_t MinutiaSetDraw(const FvsMinutiaSet_t min, FvsImage_t image) {
 
 
 /******************************************************************************
-  * ܣϸͼȡϸڵ㣬浽С
-  *       ϸڵ㼯ϱ㹻̫Сˣ˺ֹͣϸڵ㡣
-  * minutia      ϸڵ㼯ϣϸڵ
-  *       image        ϸͼ
-  *       direction    㷽
-  *       mask         ʾЧָ
-  * أ
+  * 功能：从细化图像中提取细节点，并储存到集合中。
+  *       申请的细节点集合必须足够大，如果太小了，满了后会停止搜索细节点。
+  * 参数：minutia      细节点集合，用来保存细节点
+  *       image        细化后的图像
+  *       direction    用来计算方向用
+  *       mask         用来表示有效的指纹区域
+  * 返回：错误编号
 ******************************************************************************/
 FvsError_t MinutiaSetExtract
 (
@@ -270,10 +271,11 @@ FvsError_t MinutiaSetExtract
     FvsFloat_t angle = 0.0;
     FvsInt_t   whitecount;
     int cnt = 0;
+    FVS_PROFILE_BEGIN(tprof);
     if (m == NULL || p == NULL)
         return FvsMemory;
     (void)MinutiaSetEmpty(minutia);
-    /* ͼȡϸڵ */
+    /* 遍历图像，提取细节点 */
     for (y = 1; y < h - 1; y++)
         for (x = 1; x < w - 1; x++) {
             if (m[x + y * pitchm] == 0)
@@ -290,10 +292,10 @@ FvsError_t MinutiaSetExtract
                 if (P8 != 0) whitecount++;
                 switch(whitecount) {
                     case 0:
-                        /* 㣬 */
+                        /* 孤立点，忽略 */
                         break;
                     case 1:
-                        /* Ƕ */
+                        /* 检测角度 */
                         angle = FloatFieldGetValue(direction, x, y);
                         (void)MinutiaSetAdd(minutia, (FvsFloat_t)x, (FvsFloat_t)y, FvsMinutiaTypeEnding, (FvsFloat_t)angle);
                         ++cnt;
@@ -311,6 +313,81 @@ FvsError_t MinutiaSetExtract
         }
     (void)MinutiaSetCheckClean(minutia);
     fprintf(stdout, "%d\n", cnt);
+    FVS_PROFILE_END(tprof, FvsProfileMinutia, w * h, 0, MinutiaSetGetCount(minutia));
+    return FvsOK;
+}
+
+
+/* 最低的1位的序号 */
+static FvsInt_t MinutiaLowestBit(FvsUint64_t v) {
+#if defined __GNUC__
+    return __builtin_ctzll(v);
+#else
+    FvsInt_t n = 0;
+    while ((v & 1) == 0) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+
+/******************************************************************************
+  * 功能：从1位细化图像中提取细节点，结果与 MinutiaSetExtract 相同
+  *       一次统计一个字中64个象素的邻点个数，只有端点（1个邻点）和
+  *       分歧点（3个以上邻点）才逐个处理，顺序仍是光栅顺序。
+  * 参数：minutia      细节点集合，用来保存细节点
+  *       image        细化后的1位图像
+  *       direction    用来计算方向用
+  *       mask         用来表示有效的指纹区域
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t MinutiaSetExtractBits
+(
+    FvsMinutiaSet_t       minutia,
+    const FvsBitImage_t   image,
+    const FvsFloatField_t direction,
+    const FvsImage_t      mask
+) {
+    FvsInt_t w      = BitImageGetWidth(image);
+    FvsInt_t h      = BitImageGetHeight(image);
+    FvsInt_t words  = BitImageGetWords(image);
+    FvsInt_t pitchm = ImageGetPitch(mask);
+    FvsUint64_t* p  = BitImageGetBuffer(image);
+    FvsByte_t* m    = ImageGetBuffer(mask);
+    FvsUint64_t s[4], one, many, cand;
+    FvsInt_t   x, y, k, b;
+    FvsFloat_t angle = 0.0;
+    FVS_PROFILE_BEGIN(tprof);
+    if (m == NULL || p == NULL)
+        return FvsMemory;
+    (void)MinutiaSetEmpty(minutia);
+    /* 遍历图像，提取细节点 */
+    for (y = 1; y < h - 1; y++)
+        for (k = 0; k < words; k++) {
+            if (p[y * words + k] == 0)
+                continue;
+            BitImageNeighbourCount(image, y, k, s);
+            one  = s[0] & ~s[1] & ~s[2] & ~s[3];
+            many = (s[0] & s[1]) | s[2] | s[3];
+            cand = p[y * words + k] & (one | many);
+            while (cand != 0) {
+                b = MinutiaLowestBit(cand);
+                cand &= cand - 1;
+                x = (k << 6) + b;
+                if (x < 1 || x >= w - 1)
+                    continue;
+                if (m[x + y * pitchm] == 0)
+                    continue;
+                angle = FloatFieldGetValue(direction, x, y);
+                (void)MinutiaSetAdd(minutia, (FvsFloat_t)x, (FvsFloat_t)y,
+                                    ((one >> b) & 1) ? FvsMinutiaTypeEnding : FvsMinutiaTypeBranching,
+                                    (FvsFloat_t)angle);
+            }
+        }
+    (void)MinutiaSetCheckClean(minutia);
+    FVS_PROFILE_END(tprof, FvsProfileMinutia, w * h, 0, MinutiaSetGetCount(minutia));
     return FvsOK;
 }
 
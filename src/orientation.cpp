@@ -0,0 +1,129 @@
+
+/*#############################################################################
+ * 文件名：orientation.cpp
+ * 功能：  量化为8位的脊线方向和方向向量查找表
+#############################################################################*/
+
+#include <math.h>
+
+#include "orientation.h"
+
+
+#define ORIENTATION_STEP    (M_PI / FVS_ORIENTATION_LEVELS)
+
+
+/* 方向向量查找表 */
+typedef struct OrientationTables_t {
+    FvsFloat_t  c[FVS_ORIENTATION_LEVELS];
+    FvsFloat_t  s[FVS_ORIENTATION_LEVELS];
+} OrientationTables_t;
+
+
+static OrientationTables_t OrientationBuildTables() {
+    OrientationTables_t t;
+    FvsInt_t i;
+    for (i = 0; i < FVS_ORIENTATION_LEVELS; i++) {
+        t.c[i] = cos(OrientationAngle((FvsByte_t)i));
+        t.s[i] = sin(OrientationAngle((FvsByte_t)i));
+    }
+    return t;
+}
+
+
+/******************************************************************************
+  * 功能：把方向量化为级别
+  * 参数：angle  方向（弧度），任意范围，按 PI 的周期折算
+  * 返回：级别 0 .. 255
+******************************************************************************/
+FvsByte_t OrientationQuantize(const FvsFloat_t angle) {
+    FvsInt_t level = (FvsInt_t)floor((angle + M_PI / 2) / ORIENTATION_STEP + 0.5);
+    /* 按 PI 的周期折算到 0 .. 255 */
+    return (FvsByte_t)(level & (FVS_ORIENTATION_LEVELS - 1));
+}
+
+
+/******************************************************************************
+  * 功能：获得级别对应的方向
+  * 参数：level  级别
+  * 返回：方向 [-PI/2, PI/2)
+******************************************************************************/
+FvsFloat_t OrientationAngle(const FvsByte_t level) {
+    return -M_PI / 2 + level * ORIENTATION_STEP;
+}
+
+
+/******************************************************************************
+  * 功能：获得方向向量的查找表，cos 和 sin 各 256 项，按级别索引
+  * 参数：cosTable  输出余弦表，可以为空
+  *       sinTable  输出正弦表，可以为空
+  * 返回：无
+******************************************************************************/
+void OrientationGetTables(const FvsFloat_t** cosTable, const FvsFloat_t** sinTable) {
+    /* 局部静态对象的初始化只进行一次，并且是线程安全的 */
+    static const OrientationTables_t tables = OrientationBuildTables();
+    if (cosTable != NULL)
+        *cosTable = tables.c;
+    if (sinTable != NULL)
+        *sinTable = tables.s;
+}
+
+
+/******************************************************************************
+  * 功能：把浮点方向图量化为8位方向图
+  * 参数：orientation  输出的方向图，大小与 direction 相同
+  *       direction    脊线方向
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t OrientationFromField(FvsImage_t orientation, const FvsFloatField_t direction) {
+    FvsInt_t w     = FloatFieldGetWidth (direction);
+    FvsInt_t h     = FloatFieldGetHeight(direction);
+    FvsInt_t pitch = FloatFieldGetPitch (direction);
+    FvsFieldFloat_t* dir = FloatFieldGetBuffer(direction);
+    FvsByte_t* out;
+    FvsInt_t pitcho, x, y;
+    FvsError_t nRet = ImageSetSize(orientation, w, h);
+    if (nRet != FvsOK)
+        return nRet;
+    out    = ImageGetBuffer(orientation);
+    pitcho = ImageGetPitch (orientation);
+    if (w * h == 0)
+        return FvsOK;
+    if (dir == NULL || out == NULL)
+        return FvsMemory;
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            out[x + y * pitcho] = OrientationQuantize(dir[x + y * pitch]);
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：把8位方向图还原为浮点方向图
+  * 参数：direction    输出的脊线方向
+  *       orientation  量化的方向图
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t OrientationToField(FvsFloatField_t direction, const FvsImage_t orientation) {
+    FvsInt_t w      = ImageGetWidth (orientation);
+    FvsInt_t h      = ImageGetHeight(orientation);
+    FvsInt_t pitcho = ImageGetPitch (orientation);
+    FvsByte_t* in   = ImageGetBuffer(orientation);
+    FvsFieldFloat_t* dir;
+    FvsFieldFloat_t angle[FVS_ORIENTATION_LEVELS];
+    FvsInt_t pitch, x, y, i;
+    FvsError_t nRet = FloatFieldSetSize(direction, w, h);
+    if (nRet != FvsOK)
+        return nRet;
+    dir   = FloatFieldGetBuffer(direction);
+    pitch = FloatFieldGetPitch (direction);
+    if (w * h == 0)
+        return FvsOK;
+    if (dir == NULL || in == NULL)
+        return FvsMemory;
+    for (i = 0; i < FVS_ORIENTATION_LEVELS; i++)
+        angle[i] = (FvsFieldFloat_t)OrientationAngle((FvsByte_t)i);
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            dir[x + y * pitch] = angle[in[x + y * pitcho]];
+    return FvsOK;
+}
@@ -0,0 +1,68 @@
+/*#############################################################################
+ * 文件名：orientation.h
+ * 功能：  量化为8位的脊线方向和方向向量查找表
+#############################################################################*/
+
+#if !defined FVS__ORIENTATION_HEADER__INCLUDED__
+#define FVS__ORIENTATION_HEADER__INCLUDED__
+
+#include "image.h"
+#include "floatfield.h"
+
+
+/******************************************************************************
+** 脊线方向的范围是 [-PI/2, PI/2)，量化为 256 级，第 i 级的角度为
+**   -PI/2 + i.PI/256
+** 量化误差不超过 PI/512（约0.35度）。方向图可以保存在普通的8位图像中，
+** 只占浮点域的 1/8；需要方向向量时按级别查表，不再计算三角函数。
+** 方向以 PI 为周期，PI/2 与 -PI/2 是同一个方向，都量化为第0级。
+******************************************************************************/
+
+#define FVS_ORIENTATION_LEVELS  256
+
+
+/******************************************************************************
+  * 功能：把方向量化为级别
+  * 参数：angle  方向（弧度），任意范围，按 PI 的周期折算
+  * 返回：级别 0 .. 255
+******************************************************************************/
+FvsByte_t OrientationQuantize(const FvsFloat_t angle);
+
+
+/******************************************************************************
+  * 功能：获得级别对应的方向
+  * 参数：level  级别
+  * 返回：方向 [-PI/2, PI/2)
+******************************************************************************/
+FvsFloat_t OrientationAngle(const FvsByte_t level);
+
+
+/******************************************************************************
+  * 功能：获得方向向量的查找表，cos 和 sin 各 256 项，按级别索引。
+  *       表在第一次调用时计算，以后只读，多个线程可以同时使用
+  * 参数：cosTable  输出余弦表，可以为空
+  *       sinTable  输出正弦表，可以为空
+  * 返回：无
+******************************************************************************/
+void OrientationGetTables(const FvsFloat_t** cosTable, const FvsFloat_t** sinTable);
+
+
+/******************************************************************************
+  * 功能：把浮点方向图量化为8位方向图
+  * 参数：orientation  输出的方向图，大小与 direction 相同
+  *       direction    脊线方向
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t OrientationFromField(FvsImage_t orientation, const FvsFloatField_t direction);
+
+
+/******************************************************************************
+  * 功能：把8位方向图还原为浮点方向图
+  * 参数：direction    输出的脊线方向
+  *       orientation  量化的方向图
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t OrientationToField(FvsFloatField_t direction, const FvsImage_t orientation);
+
+
+#endif /* FVS__ORIENTATION_HEADER__INCLUDED__ */
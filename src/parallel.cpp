@@ -0,0 +1,297 @@
+/*#############################################################################
+ * 文件名：parallel.cpp
+ * 功能：  库内部使用的并行循环
+#############################################################################*/
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+
+/******************************************************************************
+** 工作窃取（work-stealing）的任务调度。
+** 每个工作线程有自己的任务队列，另有一个队列给不属于线程池的调用线程。
+** 一个任务是某个循环的一段 [begin, end)，执行时先把后一半放回自己的队列，
+** 直到只剩一项，所以大的区间会被逐步拆开。
+** 线程从自己队列的尾部取任务（刚拆出的、数据还在缓存中的一段），
+** 自己的队列为空时从其它队列的头部窃取（最大的一段）。
+** 等待循环结束的线程不阻塞，而是继续处理任务，所以在任务中再调用
+** ParallelFor 不会死锁，也不会产生更多的线程：嵌套的循环和其它线程的
+** 循环都分给同一组工作线程。
+******************************************************************************/
+typedef struct iParallelJob_t {
+    FvsParallelFunc_t           func;
+    FvsPointer_t                context;
+    std::atomic<FvsInt_t>       left;       /* 尚未完成的项数 */
+} iParallelJob_t;
+
+
+typedef struct iParallelTask_t {
+    iParallelJob_t*             job;
+    FvsInt_t                    begin;
+    FvsInt_t                    end;
+} iParallelTask_t;
+
+
+typedef struct iParallelQueue_t {
+    std::mutex                  lock;
+    std::deque<iParallelTask_t> tasks;
+} iParallelQueue_t;
+
+
+typedef struct iParallelPool_t {
+    /* 启动和停止工作线程 */
+    std::mutex                  config;
+    std::condition_variable     idle;
+    FvsInt_t                    loops;      /* 正在进行的最外层循环   */
+    FvsBool_t                   resizing;   /* 正在改变线程数         */
+    std::vector<std::thread>    threads;
+    /* 最后一个队列属于线程池之外的调用线程 */
+    std::vector<std::unique_ptr<iParallelQueue_t> > queues;
+    std::atomic<FvsInt_t>       count;      /* 设置的线程数           */
+    /* 没有任务时休眠 */
+    std::mutex                  lock;
+    std::condition_variable     wake;
+    std::atomic<FvsInt_t>       sleeping;
+    std::atomic<FvsInt_t>       queued;     /* 所有队列中的任务数     */
+    FvsBool_t                   quit;
+
+    iParallelPool_t() : loops(0), resizing(FvsFalse), count(0), sleeping(0),
+        queued(0), quit(FvsFalse) {}
+    ~iParallelPool_t();
+} iParallelPool_t;
+
+
+static iParallelPool_t s_pool;
+
+/* 当前线程的队列，线程池之外的线程为 -1 */
+static thread_local FvsInt_t s_worker = -1;
+/* 当前线程中尚未返回的 ParallelFor 的层数 */
+static thread_local FvsInt_t s_depth = 0;
+
+
+static FvsInt_t ParallelOwnQueue(iParallelPool_t* pool) {
+    return (s_worker >= 0) ? s_worker : (FvsInt_t)pool->queues.size() - 1;
+}
+
+
+static void ParallelPush(iParallelPool_t* pool, const iParallelTask_t& task) {
+    iParallelQueue_t* q = pool->queues[ParallelOwnQueue(pool)].get();
+    {
+        std::lock_guard<std::mutex> guard(q->lock);
+        q->tasks.push_back(task);
+    }
+    pool->queued++;
+    /* 与 ParallelSleep 中的检查配对，不会丢失唤醒 */
+    if (pool->sleeping > 0) {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->wake.notify_one();
+    }
+}
+
+
+/* 先取自己队列的尾部，再窃取其它队列的头部 */
+static FvsBool_t ParallelFind(iParallelPool_t* pool, iParallelTask_t* task) {
+    FvsInt_t n = (FvsInt_t)pool->queues.size();
+    FvsInt_t own = ParallelOwnQueue(pool);
+    FvsInt_t k;
+    if (pool->queued <= 0)
+        return FvsFalse;
+    for (k = 0; k < n; k++) {
+        iParallelQueue_t* q = pool->queues[(own + k) % n].get();
+        std::lock_guard<std::mutex> guard(q->lock);
+        if (q->tasks.empty())
+            continue;
+        if (k == 0) {
+            *task = q->tasks.back();
+            q->tasks.pop_back();
+        }
+        else {
+            *task = q->tasks.front();
+            q->tasks.pop_front();
+        }
+        pool->queued--;
+        return FvsTrue;
+    }
+    return FvsFalse;
+}
+
+
+/* 拆成单项执行，后一半留给其它线程窃取 */
+static void ParallelRunTask(iParallelPool_t* pool, iParallelTask_t task) {
+    iParallelJob_t* job = task.job;
+    FvsInt_t i, mid;
+    while (task.end - task.begin > 1) {
+        iParallelTask_t half = task;
+        mid = task.begin + (task.end - task.begin) / 2;
+        half.begin = mid;
+        task.end   = mid;
+        ParallelPush(pool, half);
+    }
+    for (i = task.begin; i < task.end; i++)
+        job->func(i, job->context);
+    /* 最后一项完成时唤醒等待的线程，之后不能再访问 job */
+    if (job->left.fetch_sub(task.end - task.begin) == task.end - task.begin) {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->wake.notify_all();
+    }
+}
+
+
+/* 没有任务可做时休眠，直到有新任务、job 完成或者线程池退出 */
+static void ParallelSleep(iParallelPool_t* pool, const iParallelJob_t* job) {
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->sleeping++;
+    while (pool->quit == FvsFalse && pool->queued <= 0 &&
+            (job == NULL || job->left > 0))
+        pool->wake.wait(guard);
+    pool->sleeping--;
+}
+
+
+static void ParallelWorker(iParallelPool_t* pool, const FvsInt_t index) {
+    iParallelTask_t task;
+    s_worker = index;
+    for (;;) {
+        if (ParallelFind(pool, &task) == FvsTrue) {
+            ParallelRunTask(pool, task);
+            continue;
+        }
+        ParallelSleep(pool, NULL);
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            if (pool->quit == FvsTrue)
+                return;
+        }
+    }
+}
+
+
+/* 结束所有工作线程，调用者必须持有 config 且没有循环在进行 */
+static void ParallelStop(iParallelPool_t* pool) {
+    size_t i;
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->quit = FvsTrue;
+        pool->wake.notify_all();
+    }
+    for (i = 0; i < pool->threads.size(); i++)
+        pool->threads[i].join();
+    pool->threads.clear();
+    pool->queues.clear();
+    pool->quit = FvsFalse;
+}
+
+
+iParallelPool_t::~iParallelPool_t() {
+    std::lock_guard<std::mutex> guard(config);
+    ParallelStop(this);
+}
+
+
+/* 开始一个最外层的循环，需要时创建工作线程 */
+static void ParallelEnter(iParallelPool_t* pool) {
+    FvsInt_t i, threads;
+    std::unique_lock<std::mutex> guard(pool->config);
+    while (pool->resizing == FvsTrue)
+        pool->idle.wait(guard);
+    if (pool->queues.empty()) {
+        threads = ParallelGetThreadCount();
+        for (i = 0; i < threads; i++)
+            pool->queues.push_back(std::unique_ptr<iParallelQueue_t>(new iParallelQueue_t));
+        for (i = 0; i < threads - 1; i++)
+            pool->threads.push_back(std::thread(ParallelWorker, pool, i));
+    }
+    pool->loops++;
+}
+
+
+static void ParallelLeave(iParallelPool_t* pool) {
+    std::lock_guard<std::mutex> guard(pool->config);
+    if (--pool->loops == 0)
+        pool->idle.notify_all();
+}
+
+
+/******************************************************************************
+  * 功能：设置并行处理使用的线程数（包括调用线程）
+  * 参数：count   线程数，小于等于0表示使用处理器的个数
+  * 返回：无
+******************************************************************************/
+void ParallelSetThreadCount(const FvsInt_t count) {
+    std::unique_lock<std::mutex> guard(s_pool.config);
+    while (s_pool.resizing == FvsTrue)
+        s_pool.idle.wait(guard);
+    s_pool.resizing = FvsTrue;
+    while (s_pool.loops > 0)
+        s_pool.idle.wait(guard);
+    ParallelStop(&s_pool);
+    s_pool.count = (count > 0) ? count : 0;
+    s_pool.resizing = FvsFalse;
+    s_pool.idle.notify_all();
+}
+
+
+/******************************************************************************
+  * 功能：获得并行处理使用的线程数
+  * 参数：无
+  * 返回：线程数
+******************************************************************************/
+FvsInt_t ParallelGetThreadCount() {
+    FvsInt_t count = s_pool.count;
+    if (count <= 0)
+        count = (FvsInt_t)std::thread::hardware_concurrency();
+    return (count > 0) ? count : 1;
+}
+
+
+/******************************************************************************
+  * 功能：对 0..count-1 的每一项调用 func，返回时所有项都已处理完。
+  * 参数：count    项数
+  *       func     处理函数
+  *       context  传给 func 的参数
+  * 返回：无
+******************************************************************************/
+void ParallelFor(const FvsInt_t count, FvsParallelFunc_t func, FvsPointer_t context) {
+    iParallelJob_t job;
+    iParallelTask_t task;
+    FvsInt_t i, threads;
+    FvsBool_t outer;
+    if (count <= 0)
+        return;
+    threads = ParallelGetThreadCount();
+    /* 只有一项或一个线程时顺序执行 */
+    if (count == 1 || threads == 1) {
+        for (i = 0; i < count; i++)
+            func(i, context);
+        return;
+    }
+    /* 工作线程和嵌套的调用已经在某个循环之中 */
+    outer = (s_worker < 0 && s_depth == 0) ? FvsTrue : FvsFalse;
+    if (outer == FvsTrue)
+        ParallelEnter(&s_pool);
+    s_depth++;
+    job.func    = func;
+    job.context = context;
+    job.left    = count;
+    task.job    = &job;
+    task.begin  = 0;
+    task.end    = count;
+    ParallelPush(&s_pool, task);
+    /* 等待时处理任何循环的任务 */
+    while (job.left > 0) {
+        if (ParallelFind(&s_pool, &task) == FvsTrue)
+            ParallelRunTask(&s_pool, task);
+        else
+            ParallelSleep(&s_pool, &job);
+    }
+    s_depth--;
+    if (outer == FvsTrue)
+        ParallelLeave(&s_pool);
+}
@@ -0,0 +1,55 @@
+/*#############################################################################
+ * 文件名：parallel.h
+ * 功能：  库内部使用的并行循环
+#############################################################################*/
+
+#if !defined FVS__PARALLEL_HEADER__INCLUDED__
+#define FVS__PARALLEL_HEADER__INCLUDED__
+
+/* 基本类型定义 */
+#include "fvstypes.h"
+
+
+/******************************************************************************
+  * 功能：并行循环中每一项的处理函数
+  * 参数：index    项的序号，0..count-1
+  *       context  调用者的参数
+  * 返回：无
+******************************************************************************/
+typedef void (*FvsParallelFunc_t)(const FvsInt_t index, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：设置并行处理使用的线程数（包括调用线程），即工作线程数加1。
+  *       所有线程中的循环共用这些工作线程，宿主程序用它限制库使用的线程。
+  *       线程池在第一次需要时创建，改变线程数会等待正在进行的循环结束，
+  *       不能在循环的处理函数中调用。
+  * 参数：count   线程数，小于等于0表示使用处理器的个数
+  * 返回：无
+******************************************************************************/
+void ParallelSetThreadCount(const FvsInt_t count);
+
+
+/******************************************************************************
+  * 功能：获得并行处理使用的线程数
+  * 参数：无
+  * 返回：线程数
+******************************************************************************/
+FvsInt_t ParallelGetThreadCount(void);
+
+
+/******************************************************************************
+  * 功能：对 0..count-1 的每一项调用 func，返回时所有项都已处理完。
+  *       各项之间没有顺序保证，func 必须可以在多个线程中同时调用。
+  *       各项作为任务交给工作窃取的调度器，调用线程在等待时也处理任务。
+  *       在 func 中再调用 ParallelFor，或者多个线程同时调用时，
+  *       所有的项都分给同一组工作线程，不会产生更多的线程。
+  * 参数：count    项数
+  *       func     处理函数
+  *       context  传给 func 的参数
+  * 返回：无
+******************************************************************************/
+void ParallelFor(const FvsInt_t count, FvsParallelFunc_t func, FvsPointer_t context);
+
+
+#endif /* FVS__PARALLEL_HEADER__INCLUDED__ */
@@ -0,0 +1,691 @@
+
+/*#############################################################################
+ * 文件名：pipeline.cpp
+ * 功能：  按名字组装的处理流程，运行时选择各阶段的算法并计时
+#############################################################################*/
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "pipeline.h"
+
+
+#define PIPELINE_MAXNAME    32
+
+
+struct iFvsPipeline_t;
+
+/* 阶段的处理函数，params 总是有 FVS_PIPELINE_PARAMS 个，pipeline 用于取消检查 */
+typedef FvsError_t (*iFvsStageFunc_t)(FvsPipelineData_t* data, const FvsFloat_t* params,
+                                      const struct iFvsPipeline_t* pipeline);
+
+
+/* 一种可用的阶段 */
+typedef struct iFvsStageType_t {
+    const char*      name;
+    iFvsStageFunc_t  func;
+    FvsInt_t         count;                         /* 参数个数 */
+    FvsFloat_t       defaults[FVS_PIPELINE_PARAMS];
+    FvsFloat_t       minimum[FVS_PIPELINE_PARAMS];  /* 参数的取值范围，含两端 */
+    FvsFloat_t       maximum[FVS_PIPELINE_PARAMS];
+    FvsUint_t        inputs;
+    FvsUint_t        outputs;
+} iFvsStageType_t;
+
+
+/* 流程中的一个阶段 */
+typedef struct iFvsStage_t {
+    const iFvsStageType_t*  type;
+    FvsFloat_t              params[FVS_PIPELINE_PARAMS];
+    FvsPipelineStats_t      stats;
+} iFvsStage_t;
+
+
+/* 流程对象 */
+typedef struct iFvsPipeline_t {
+    iFvsStage_t*         stages;
+    FvsInt_t             count;
+    FvsInt_t             capacity;
+    FvsPipelineCancel_t  cancelled;
+    FvsPointer_t         context;     /* 传给 cancelled 的参数 */
+} iFvsPipeline_t;
+
+
+/* 分块增强的每块回调，转为流程的取消检查 */
+static FvsBool_t PipelineTileProgress(const FvsInt_t tile, FvsPointer_t context) {
+    const iFvsPipeline_t* p = (const iFvsPipeline_t*)context;
+    (void)tile;
+    return (p->cancelled(p->context) == FvsTrue) ? FvsFalse : FvsTrue;
+}
+
+
+/* 各阶段的实现，参数依次对应描述中括号里的值 */
+static FvsError_t StageSoften(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return ImageSoftenMean(d->image, (FvsInt_t)p[0]);
+}
+
+static FvsError_t StageNormalize(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return ImageNormalize(d->image, (FvsByte_t)p[0], (FvsUint_t)p[1]);
+}
+
+static FvsError_t StageSoftenNormalize(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                       const iFvsPipeline_t*) {
+    return ImageSoftenNormalize(d->image, (FvsInt_t)p[0], (FvsByte_t)p[1], (FvsUint_t)p[2]);
+}
+
+static FvsError_t StageNormalizeLocal(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                      const iFvsPipeline_t*) {
+    return ImageNormalizeLocal(d->image, (FvsInt_t)p[0], (FvsByte_t)p[1], (FvsUint_t)p[2]);
+}
+
+static FvsError_t StageDirection(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return FingerprintGetDirection(d->image, d->direction, (FvsInt_t)p[0], (FvsInt_t)p[1]);
+}
+
+static FvsError_t StageFrequency(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintGetFrequency(d->image, d->direction, d->frequency);
+}
+
+static FvsError_t StageFrequency1(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                  const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintGetFrequency1(d->image, d->direction, d->frequency);
+}
+
+static FvsError_t StageFrequency2(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                  const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintGetFrequency2(d->image, d->direction, d->frequency);
+}
+
+static FvsError_t StageFrequencyBlock(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                      const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintGetFrequencyBlock(d->image, d->direction, d->frequency);
+}
+
+static FvsError_t StageSpectral(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintAnalyzeSpectral(d->image, d->direction, d->frequency, d->mask, NULL);
+}
+
+static FvsError_t StageMask(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return FingerprintGetMask(d->image, d->direction, d->frequency, d->mask);
+}
+
+static FvsError_t StageEnhanceTiled(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                    const iFvsPipeline_t* pl) {
+    /* 每块之后检查取消 */
+    return FingerprintEnhanceTiled(d->image, d->direction, d->frequency, d->mask,
+                                   p[0], (FvsInt_t)p[1],
+                                   (pl->cancelled != NULL) ? PipelineTileProgress : NULL,
+                                   (FvsPointer_t)pl);
+}
+
+static FvsError_t StageGabor(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return ImageEnhanceGaborFilter(d->image, d->direction, d->frequency, d->mask,
+                                   p[0], FvsGaborTable);
+}
+
+static FvsError_t StageGaborFull(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return ImageEnhanceGaborFilter(d->image, d->direction, d->frequency, d->mask,
+                                   p[0], FvsGaborFull);
+}
+
+static FvsError_t StageGaborAdaptive(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                     const iFvsPipeline_t*) {
+    return ImageEnhanceGaborFilter(d->image, d->direction, d->frequency, d->mask,
+                                   p[0], FvsGaborAdaptive);
+}
+
+static FvsError_t StageGaborBinarize(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                     const iFvsPipeline_t*) {
+    return ImageEnhanceGaborBinarize(d->image, d->direction, d->frequency, d->mask,
+                                     p[0], (FvsByte_t)p[1], NULL);
+}
+
+static FvsError_t StageGaborBinarizeBits(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                         const iFvsPipeline_t*) {
+    return ImageEnhanceGaborBinarize(d->image, d->direction, d->frequency, d->mask,
+                                     p[0], (FvsByte_t)p[1], d->bits);
+}
+
+static FvsError_t StageBinarize(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    return ImageBinarize(d->image, (FvsByte_t)p[0]);
+}
+
+static FvsError_t StageThinConnectivity(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                        const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinConnectivity(d->image);
+}
+
+static FvsError_t StageThinHitMiss(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                   const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinHitMiss(d->image);
+}
+
+static FvsError_t StageThinConnectivityTable(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                             const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinTable(d->image, FvsThinConnectivity);
+}
+
+static FvsError_t StageThinHitMissTable(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                        const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinTable(d->image, FvsThinHitMiss);
+}
+
+static FvsError_t StageThinConnectivityList(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                            const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinWorkList(d->image, FvsThinConnectivity);
+}
+
+static FvsError_t StageThinHitMissList(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                       const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinWorkList(d->image, FvsThinHitMiss);
+}
+
+static FvsError_t StageThinConnectivityParallel(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                                const iFvsPipeline_t*) {
+    (void)p;
+    return ImageThinConnectivityParallel(d->image);
+}
+
+static FvsError_t StageSpurs(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return ImageRemoveSpurs(d->image);
+}
+
+static FvsError_t StagePack(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return BitImageFromImage(d->bits, d->image);
+}
+
+static FvsError_t StageUnpack(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return BitImageToImage(d->image, d->bits);
+}
+
+static FvsError_t StageThinConnectivityBits(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                            const iFvsPipeline_t*) {
+    (void)p;
+    return BitImageThinConnectivity(d->bits);
+}
+
+static FvsError_t StageThinHitMissBits(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                       const iFvsPipeline_t*) {
+    (void)p;
+    return BitImageThinHitMiss(d->bits);
+}
+
+static FvsError_t StageSpursBits(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return BitImageRemoveSpurs(d->bits);
+}
+
+static FvsError_t StageMinutia(FvsPipelineData_t* d, const FvsFloat_t* p, const iFvsPipeline_t*) {
+    (void)p;
+    return MinutiaSetExtract(d->minutia, d->image, d->direction, d->mask);
+}
+
+static FvsError_t StageMinutiaBits(FvsPipelineData_t* d, const FvsFloat_t* p,
+                                   const iFvsPipeline_t*) {
+    (void)p;
+    return MinutiaSetExtractBits(d->minutia, d->bits, d->direction, d->mask);
+}
+
+
+#define IMG     FvsPipelineImage
+#define DIR     FvsPipelineDirection
+#define FREQ    FvsPipelineFrequency
+#define MASK    FvsPipelineMask
+#define BITS    FvsPipelineBits
+#define MINU    FvsPipelineMinutia
+#define ENH     FvsPipelineEnhanced
+#define BIN     FvsPipelineBinarized
+#define THIN    FvsPipelineThinned
+
+
+/* 可用的阶段：名字、函数、参数个数、缺省值、最小值和最大值、读取的数据、写入的数据 */
+static const iFvsStageType_t s_types[] = {
+    { "soften",              StageSoften,                    1, { 3 },              { 1 },       { 31 },              IMG,               IMG },
+    { "normalize",           StageNormalize,                 2, { 100, 10000 },     { 0, 0 },    { 255, 65025 },      IMG,               IMG },
+    { "soften-normalize",    StageSoftenNormalize,           3, { 3, 100, 10000 },  { 1, 0, 0 }, { 31, 255, 65025 },  IMG,               IMG },
+    { "normalize-local",     StageNormalizeLocal,            3, { 32, 100, 10000 }, { 1, 0, 0 }, { 512, 255, 65025 }, IMG,               IMG },
+    { "direction",           StageDirection,                 2, { 7, 8 },           { 1, 0 },    { 7, 16 },           IMG,               DIR },
+    { "frequency",           StageFrequency,                 0, { 0 },              { 0 },       { 0 },               IMG|DIR,           FREQ },
+    { "frequency1",          StageFrequency1,                0, { 0 },              { 0 },       { 0 },               IMG|DIR,           FREQ },
+    { "frequency2",          StageFrequency2,                0, { 0 },              { 0 },       { 0 },               IMG|DIR,           FREQ },
+    { "frequency-block",     StageFrequencyBlock,            0, { 0 },              { 0 },       { 0 },               IMG|DIR,           FREQ },
+    { "spectral",            StageSpectral,                  0, { 0 },              { 0 },       { 0 },               IMG,               DIR|FREQ|MASK },
+    { "mask",                StageMask,                      0, { 0 },              { 0 },       { 0 },               IMG|DIR|FREQ,      MASK },
+    { "enhance-tiled",       StageEnhanceTiled,              2, { 4.0, 0 },         { 1, 0 },    { 8, 4096 },         IMG,               IMG|DIR|FREQ|MASK|ENH },
+    { "gabor",               StageGabor,                     1, { 4.0 },            { 1 },       { 8 },               IMG|DIR|FREQ|MASK, IMG|ENH },
+    { "gabor-full",          StageGaborFull,                 1, { 4.0 },            { 1 },       { 8 },               IMG|DIR|FREQ|MASK, IMG|ENH },
+    { "gabor-adaptive",      StageGaborAdaptive,             1, { 4.0 },            { 1 },       { 8 },               IMG|DIR|FREQ|MASK, IMG|ENH },
+    { "gabor-binarize",      StageGaborBinarize,             2, { 4.0, 128 },       { 1, 0 },    { 8, 255 },          IMG|DIR|FREQ|MASK, IMG|BIN },
+    { "gabor-binarize-bits", StageGaborBinarizeBits,         2, { 4.0, 128 },       { 1, 0 },    { 8, 255 },          IMG|DIR|FREQ|MASK, BITS|BIN },
+    { "binarize",            StageBinarize,                  1, { 128 },            { 0 },       { 255 },             IMG,               IMG|BIN },
+    { "thin-connectivity",   StageThinConnectivity,          0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-hitmiss",        StageThinHitMiss,               0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-conn-table",     StageThinConnectivityTable,     0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-hitmiss-table",  StageThinHitMissTable,          0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-conn-list",      StageThinConnectivityList,      0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-hitmiss-list",   StageThinHitMissList,           0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "thin-conn-parallel",  StageThinConnectivityParallel,  0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "spurs",               StageSpurs,                     0, { 0 },              { 0 },       { 0 },               IMG,               IMG|THIN },
+    { "pack",                StagePack,                      0, { 0 },              { 0 },       { 0 },               IMG,               BITS },
+    { "unpack",              StageUnpack,                    0, { 0 },              { 0 },       { 0 },               BITS,              IMG },
+    { "thin-conn-bits",      StageThinConnectivityBits,      0, { 0 },              { 0 },       { 0 },               BITS,              BITS|THIN },
+    { "thin-hitmiss-bits",   StageThinHitMissBits,           0, { 0 },              { 0 },       { 0 },               BITS,              BITS|THIN },
+    { "spurs-bits",          StageSpursBits,                 0, { 0 },              { 0 },       { 0 },               BITS,              BITS|THIN },
+    { "minutia",             StageMinutia,                   0, { 0 },              { 0 },       { 0 },               IMG|DIR|MASK,      MINU },
+    { "minutia-bits",        StageMinutiaBits,               0, { 0 },              { 0 },       { 0 },               BITS|DIR|MASK,     MINU }
+};
+
+#define PIPELINE_TYPES  ((FvsInt_t)(sizeof(s_types) / sizeof(s_types[0])))
+
+
+static FvsUint64_t PipelineNow() {
+    return (FvsUint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/* 阶段需要的数据是否都有 */
+static FvsBool_t PipelineHasData(const FvsPipelineData_t* d, const FvsUint_t items) {
+    if ((items & IMG)  && d->image     == NULL) return FvsFalse;
+    if ((items & DIR)  && d->direction == NULL) return FvsFalse;
+    if ((items & FREQ) && d->frequency == NULL) return FvsFalse;
+    if ((items & MASK) && d->mask      == NULL) return FvsFalse;
+    if ((items & BITS) && d->bits      == NULL) return FvsFalse;
+    if ((items & MINU) && d->minutia   == NULL) return FvsFalse;
+    return FvsTrue;
+}
+
+
+/******************************************************************************
+  * 功能：创建一个空的流程
+  * 参数：无
+  * 返回：失败返回空，否则返回新的流程对象
+******************************************************************************/
+FvsPipeline_t PipelineCreate() {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)malloc(sizeof(iFvsPipeline_t));
+    if (p != NULL) {
+        p->stages    = NULL;
+        p->count     = 0;
+        p->capacity  = 0;
+        p->cancelled = NULL;
+        p->context   = NULL;
+    }
+    return (FvsPipeline_t)p;
+}
+
+
+/******************************************************************************
+  * 功能：销毁一个流程
+  * 参数：pipeline  流程对象
+  * 返回：无
+******************************************************************************/
+void PipelineDestroy(FvsPipeline_t pipeline) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL)
+        return;
+    free(p->stages);
+    free(p);
+}
+
+
+/******************************************************************************
+  * 功能：删除所有阶段
+  * 参数：pipeline  流程对象
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineClear(FvsPipeline_t pipeline) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL)
+        return FvsMemory;
+    p->count = 0;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：设置运行中的取消检查
+  * 参数：pipeline   流程对象
+  *       cancelled  取消检查，可以为空
+  *       context    传给 cancelled 的参数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineSetCancel(FvsPipeline_t pipeline, FvsPipelineCancel_t cancelled,
+                             FvsPointer_t context) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL)
+        return FvsMemory;
+    p->cancelled = cancelled;
+    p->context   = context;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：在流程末尾加入一个阶段
+  * 参数：pipeline  流程对象
+  *       name      阶段名
+  *       params    参数，可以为空
+  *       count     参数个数，其余的参数使用缺省值
+  * 返回：错误编号，阶段名未知、参数太多或超出范围、需要的数据还没有
+  *       由前面的阶段生成时返回 FvsBadParameter
+******************************************************************************/
+FvsError_t PipelineAddStage(FvsPipeline_t pipeline, const char* name,
+                            const FvsFloat_t* params, const FvsInt_t count) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    const iFvsStageType_t* type = NULL;
+    iFvsStage_t* stage;
+    FvsUint_t available = IMG;
+    FvsInt_t i;
+    if (p == NULL)
+        return FvsMemory;
+    if (name == NULL || count < 0 || (count > 0 && params == NULL))
+        return FvsBadParameter;
+    for (i = 0; i < PIPELINE_TYPES; i++)
+        if (strcmp(name, s_types[i].name) == 0) {
+            type = &s_types[i];
+            break;
+        }
+    if (type == NULL || count > type->count)
+        return FvsBadParameter;
+    /* 写成 !(a <= b) 的形式，NaN 也被拒绝 */
+    for (i = 0; i < count; i++)
+        if (!(params[i] >= type->minimum[i] && params[i] <= type->maximum[i]))
+            return FvsBadParameter;
+    /* 只有调用者给出的图像一开始就有，其余数据要由前面的阶段生成 */
+    for (i = 0; i < p->count; i++)
+        available |= p->stages[i].type->outputs;
+    if ((type->inputs & ~available) != 0)
+        return FvsBadParameter;
+    if (p->count == p->capacity) {
+        FvsInt_t capacity = (p->capacity == 0) ? 16 : 2 * p->capacity;
+        iFvsStage_t* stages = (iFvsStage_t*)realloc(p->stages, capacity * sizeof(iFvsStage_t));
+        if (stages == NULL)
+            return FvsMemory;
+        p->stages   = stages;
+        p->capacity = capacity;
+    }
+    stage = &p->stages[p->count++];
+    stage->type = type;
+    for (i = 0; i < FVS_PIPELINE_PARAMS; i++)
+        stage->params[i] = (i < count) ? params[i] : type->defaults[i];
+    memset(&stage->stats, 0, sizeof(stage->stats));
+    return FvsOK;
+}
+
+
+/* 读出描述中的一个阶段：名字和括号中的参数，s 移到阶段之后 */
+static FvsError_t PipelineParseStage(const char** str, char* name,
+                                     FvsFloat_t* params, FvsInt_t* count) {
+    const char* s = *str;
+    char* end;
+    FvsInt_t n = 0;
+    *count = 0;
+    while (isalnum((unsigned char)*s) || *s == '-' || *s == '_') {
+        if (n == PIPELINE_MAXNAME - 1)
+            return FvsBadFormat;
+        name[n++] = *s++;
+    }
+    name[n] = '\0';
+    if (n == 0)
+        return FvsBadFormat;
+    while (isspace((unsigned char)*s))
+        s++;
+    if (*s == '(') {
+        s++;
+        while (isspace((unsigned char)*s))
+            s++;
+        while (*s != ')') {
+            if (*count == FVS_PIPELINE_PARAMS)
+                return FvsBadFormat;
+            params[*count] = strtod(s, &end);
+            if (end == s)
+                return FvsBadFormat;
+            (*count)++;
+            s = end;
+            while (isspace((unsigned char)*s))
+                s++;
+            if (*s == ',') {
+                s++;
+                while (isspace((unsigned char)*s))
+                    s++;
+            }
+            else if (*s != ')')
+                return FvsBadFormat;
+        }
+        s++;
+    }
+    *str = s;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：按描述字符串重新组装流程
+  * 参数：pipeline     流程对象
+  *       description  描述，格式见 pipeline.h
+  * 返回：错误编号，格式错误时返回 FvsBadFormat，阶段无效时返回
+  *       FvsBadParameter（见 PipelineAddStage），出错时流程为空
+******************************************************************************/
+FvsError_t PipelineParse(FvsPipeline_t pipeline, const char* description) {
+    char name[PIPELINE_MAXNAME];
+    FvsFloat_t params[FVS_PIPELINE_PARAMS];
+    const char* s = description;
+    FvsError_t nRet = PipelineClear(pipeline);
+    FvsInt_t count;
+    if (nRet != FvsOK)
+        return nRet;
+    if (s == NULL)
+        return FvsBadParameter;
+    for (;;) {
+        while (isspace((unsigned char)*s))
+            s++;
+        if (*s == '\0')
+            break;
+        nRet = PipelineParseStage(&s, name, params, &count);
+        if (nRet == FvsOK)
+            nRet = PipelineAddStage(pipeline, name, params, count);
+        if (nRet != FvsOK) {
+            PipelineClear(pipeline);
+            return nRet;
+        }
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：只运行第 index 个阶段，不计时也不修改流程对象
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       data      处理的数据
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineExecuteStage(const FvsPipeline_t pipeline, const FvsInt_t index,
+                                FvsPipelineData_t* data) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    const iFvsStage_t* stage;
+    if (p == NULL)
+        return FvsMemory;
+    if (data == NULL || index < 0 || index >= p->count)
+        return FvsBadParameter;
+    stage = &p->stages[index];
+    if (!PipelineHasData(data, stage->type->inputs | stage->type->outputs))
+        return FvsBadParameter;
+    return stage->type->func(data, stage->params, p);
+}
+
+
+/******************************************************************************
+  * 功能：只运行第 index 个阶段，不调用回调
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       data      处理的数据
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineRunStage(FvsPipeline_t pipeline, const FvsInt_t index,
+                            FvsPipelineData_t* data) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    FvsPipelineStats_t* stats;
+    FvsUint64_t t;
+    FvsError_t nRet;
+    if (p == NULL)
+        return FvsMemory;
+    if (index < 0 || index >= p->count)
+        return FvsBadParameter;
+    t = PipelineNow();
+    nRet = PipelineExecuteStage(pipeline, index, data);
+    t = PipelineNow() - t;
+    stats = &p->stages[index].stats;
+    stats->calls++;
+    stats->nanoseconds += t;
+    stats->last = t;
+    return nRet;
+}
+
+
+/******************************************************************************
+  * 功能：依次运行所有阶段
+  * 参数：pipeline  流程对象
+  *       data      处理的数据，阶段需要的成员不能为空
+  *       hook      每个阶段之后调用的回调，可以为空
+  *       context   传给回调的参数
+  * 返回：错误编号，回调要求停止或被取消时返回 FvsFailure
+******************************************************************************/
+FvsError_t PipelineRun(FvsPipeline_t pipeline, FvsPipelineData_t* data,
+                       FvsPipelineHook_t hook, FvsPointer_t context) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    FvsError_t nRet = FvsOK;
+    FvsInt_t i;
+    if (p == NULL)
+        return FvsMemory;
+    if (data == NULL)
+        return FvsBadParameter;
+    for (i = 0; i < p->count && nRet == FvsOK; i++) {
+        if (p->cancelled != NULL && p->cancelled(p->context) == FvsTrue)
+            return FvsFailure;
+        nRet = PipelineRunStage(pipeline, i, data);
+        if (nRet == FvsOK && hook != NULL &&
+                hook(i, p->stages[i].type->name, data, context) == FvsFalse)
+            nRet = FvsFailure;
+    }
+    return nRet;
+}
+
+
+/******************************************************************************
+  * 功能：获得阶段的个数
+  * 参数：pipeline  流程对象
+  * 返回：阶段个数
+******************************************************************************/
+FvsInt_t PipelineGetStageCount(const FvsPipeline_t pipeline) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL)
+        return 0;
+    return p->count;
+}
+
+
+/******************************************************************************
+  * 功能：获得阶段名
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  * 返回：阶段名，序号无效时返回空
+******************************************************************************/
+const char* PipelineGetStageName(const FvsPipeline_t pipeline, const FvsInt_t index) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL || index < 0 || index >= p->count)
+        return NULL;
+    return p->stages[index].type->name;
+}
+
+
+/******************************************************************************
+  * 功能：获得阶段读取和写入的数据
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  * 返回：FvsPipelineItem_t 的组合，序号无效时返回0
+******************************************************************************/
+FvsUint_t PipelineGetStageInputs(const FvsPipeline_t pipeline, const FvsInt_t index) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL || index < 0 || index >= p->count)
+        return 0;
+    return p->stages[index].type->inputs;
+}
+
+FvsUint_t PipelineGetStageOutputs(const FvsPipeline_t pipeline, const FvsInt_t index) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL || index < 0 || index >= p->count)
+        return 0;
+    return p->stages[index].type->outputs;
+}
+
+
+/******************************************************************************
+  * 功能：读取阶段的计时
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       stats     保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineGetStageStats(const FvsPipeline_t pipeline, const FvsInt_t index,
+                                 FvsPipelineStats_t* stats) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    if (p == NULL)
+        return FvsMemory;
+    if (stats == NULL || index < 0 || index >= p->count)
+        return FvsBadParameter;
+    *stats = p->stages[index].stats;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：清零所有阶段的计时
+  * 参数：pipeline  流程对象
+  * 返回：无
+******************************************************************************/
+void PipelineResetStats(FvsPipeline_t pipeline) {
+    iFvsPipeline_t* p = (iFvsPipeline_t*)pipeline;
+    FvsInt_t i;
+    if (p == NULL)
+        return;
+    for (i = 0; i < p->count; i++)
+        memset(&p->stages[i].stats, 0, sizeof(p->stages[i].stats));
+}
+
+
+/******************************************************************************
+  * 功能：列出可用的阶段
+  * 参数：index     从0开始的序号
+  *       defaults  不为空时保存 FVS_PIPELINE_PARAMS 个缺省参数
+  *       count     不为空时保存参数个数
+  * 返回：阶段名，序号超出范围时返回空
+******************************************************************************/
+const char* PipelineGetStageType(const FvsInt_t index, FvsFloat_t* defaults,
+                                 FvsInt_t* count) {
+    if (index < 0 || index >= PIPELINE_TYPES)
+        return NULL;
+    if (defaults != NULL)
+        memcpy(defaults, s_types[index].defaults, sizeof(s_types[index].defaults));
+    if (count != NULL)
+        *count = s_types[index].count;
+    return s_types[index].name;
+}
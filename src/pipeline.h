@@ -0,0 +1,245 @@
+/*#############################################################################
+ * 文件名：pipeline.h
+ * 功能：  按名字组装的处理流程，运行时选择各阶段的算法并计时
+#############################################################################*/
+
+#if !defined FVS__PIPELINE_HEADER__INCLUDED__
+#define FVS__PIPELINE_HEADER__INCLUDED__
+
+#include "imagemanip.h"
+#include "minutia.h"
+
+
+/******************************************************************************
+** 流程由一串阶段组成，每个阶段是一个库函数和它的参数，例如：
+**   "soften-normalize(3,100,10000) direction(7,8) frequency1 mask
+**    gabor(4) binarize(128) thin-hitmiss minutia"
+** 阶段之间用空白分隔，参数写在括号中用逗号分隔，省略的参数使用缺省值。
+** 可用的阶段名由 PipelineGetStageType 列出。每个参数有取值范围，整数参数
+** 的小数部分被舍去。开始时只有 image 可用，方向、频率、掩码、1位图像和
+** 细节点都必须由前面的阶段生成，例如 mask 之前要有 direction 和 frequency，
+** 这样各阶段读到的数据总是本次运行按当前图像大小生成的。
+**
+** 各阶段在同一组数据（FvsPipelineData_t）上依次运行，数据由调用者创建，
+** 阶段用不到的成员可以为空。每次运行都记录各阶段的耗时，
+** 可以在运行时比较不同算法的组合，而不必重新编译。
+**
+** 一个流程对象同一时间只能在一个线程中运行，PipelineExecuteStage 除外。
+******************************************************************************/
+
+/* 对象的这些接口实现是私有的，不必为用户所知 */
+typedef FvsHandle_t FvsPipeline_t;
+
+
+/* 一个阶段最多的参数个数 */
+#define FVS_PIPELINE_PARAMS     4
+
+
+/* 流程处理的数据，阶段用不到的成员可以为空 */
+typedef struct FvsPipelineData_t
+{
+    FvsImage_t       image;       /* 指纹图像，原地处理     */
+    FvsFloatField_t  direction;   /* 脊线方向               */
+    FvsFloatField_t  frequency;   /* 脊线频率               */
+    FvsImage_t       mask;        /* 有效区域的掩码         */
+    FvsBitImage_t    bits;        /* 1位的二值或细化图像    */
+    FvsMinutiaSet_t  minutia;     /* 细节点集合             */
+} FvsPipelineData_t;
+
+
+/* 阶段读写的数据，用于 PipelineGetStageInputs / PipelineGetStageOutputs */
+typedef enum FvsPipelineItem_t
+{
+    FvsPipelineImage      = 0x01,   /* image 为灰度图像         */
+    FvsPipelineDirection  = 0x02,
+    FvsPipelineFrequency  = 0x04,
+    FvsPipelineMask       = 0x08,
+    FvsPipelineBits       = 0x10,
+    FvsPipelineMinutia    = 0x20,
+    FvsPipelineEnhanced   = 0x40,   /* image 为增强后的图像     */
+    FvsPipelineBinarized  = 0x80,   /* image 或 bits 为二值图像 */
+    FvsPipelineThinned    = 0x100   /* image 或 bits 为细化图像 */
+} FvsPipelineItem_t;
+
+
+/* 一个阶段的计时 */
+typedef struct FvsPipelineStats_t
+{
+    FvsUint64_t   calls;          /* 运行次数             */
+    FvsUint64_t   nanoseconds;    /* 累计墙上时间，纳秒   */
+    FvsUint64_t   last;           /* 最近一次的时间，纳秒 */
+} FvsPipelineStats_t;
+
+
+/******************************************************************************
+  * 功能：每个阶段结束后调用的回调，用于显示中间结果或取消处理
+  * 参数：index    阶段的序号
+  *       name     阶段名
+  *       data     处理的数据
+  *       context  调用者的参数
+  * 返回：返回false时停止处理
+******************************************************************************/
+typedef FvsBool_t (*FvsPipelineHook_t)(const FvsInt_t index, const char* name,
+			FvsPipelineData_t* data, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：取消检查，PipelineRun 在每个阶段之前调用，耗时较长的阶段
+  *       （enhance-tiled 每完成一块）也会调用，可能在多个线程中同时调用
+  * 参数：context  调用者的参数
+  * 返回：返回true时停止处理，正在运行的阶段返回 FvsFailure
+******************************************************************************/
+typedef FvsBool_t (*FvsPipelineCancel_t)(FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：创建一个空的流程
+  * 参数：无
+  * 返回：失败返回空，否则返回新的流程对象
+******************************************************************************/
+FvsPipeline_t PipelineCreate(void);
+
+
+/******************************************************************************
+  * 功能：销毁一个流程
+  * 参数：pipeline  流程对象
+  * 返回：无
+******************************************************************************/
+void PipelineDestroy(FvsPipeline_t pipeline);
+
+
+/******************************************************************************
+  * 功能：删除所有阶段
+  * 参数：pipeline  流程对象
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineClear(FvsPipeline_t pipeline);
+
+
+/******************************************************************************
+  * 功能：设置运行中的取消检查
+  * 参数：pipeline   流程对象
+  *       cancelled  取消检查，可以为空
+  *       context    传给 cancelled 的参数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineSetCancel(FvsPipeline_t pipeline, FvsPipelineCancel_t cancelled,
+			FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：在流程末尾加入一个阶段
+  * 参数：pipeline  流程对象
+  *       name      阶段名
+  *       params    参数，可以为空
+  *       count     参数个数，其余的参数使用缺省值
+  * 返回：错误编号，阶段名未知、参数太多或超出范围、需要的数据还没有
+  *       由前面的阶段生成时返回 FvsBadParameter
+******************************************************************************/
+FvsError_t PipelineAddStage(FvsPipeline_t pipeline, const char* name,
+			const FvsFloat_t* params, const FvsInt_t count);
+
+
+/******************************************************************************
+  * 功能：按描述字符串重新组装流程
+  * 参数：pipeline     流程对象
+  *       description  描述，格式见上
+  * 返回：错误编号，格式错误时返回 FvsBadFormat，阶段无效时返回
+  *       FvsBadParameter（见 PipelineAddStage），出错时流程为空
+******************************************************************************/
+FvsError_t PipelineParse(FvsPipeline_t pipeline, const char* description);
+
+
+/******************************************************************************
+  * 功能：依次运行所有阶段
+  * 参数：pipeline  流程对象
+  *       data      处理的数据，阶段需要的成员不能为空
+  *       hook      每个阶段之后调用的回调，可以为空
+  *       context   传给回调的参数
+  * 返回：错误编号，回调要求停止或被取消时返回 FvsFailure
+******************************************************************************/
+FvsError_t PipelineRun(FvsPipeline_t pipeline, FvsPipelineData_t* data,
+			FvsPipelineHook_t hook, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：只运行第 index 个阶段，不调用回调，计时同 PipelineRun
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       data      处理的数据
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineRunStage(FvsPipeline_t pipeline, const FvsInt_t index,
+			FvsPipelineData_t* data);
+
+
+/******************************************************************************
+  * 功能：只运行第 index 个阶段，不计时也不修改流程对象，
+  *       多个线程可以同时用不同的数据调用
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       data      处理的数据
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineExecuteStage(const FvsPipeline_t pipeline, const FvsInt_t index,
+			FvsPipelineData_t* data);
+
+
+/******************************************************************************
+  * 功能：获得阶段的个数
+  * 参数：pipeline  流程对象
+  * 返回：阶段个数
+******************************************************************************/
+FvsInt_t PipelineGetStageCount(const FvsPipeline_t pipeline);
+
+
+/******************************************************************************
+  * 功能：获得阶段名
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  * 返回：阶段名，序号无效时返回空
+******************************************************************************/
+const char* PipelineGetStageName(const FvsPipeline_t pipeline, const FvsInt_t index);
+
+
+/******************************************************************************
+  * 功能：获得阶段读取和写入的数据
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  * 返回：FvsPipelineItem_t 的组合，序号无效时返回0
+******************************************************************************/
+FvsUint_t PipelineGetStageInputs(const FvsPipeline_t pipeline, const FvsInt_t index);
+FvsUint_t PipelineGetStageOutputs(const FvsPipeline_t pipeline, const FvsInt_t index);
+
+
+/******************************************************************************
+  * 功能：读取阶段的计时
+  * 参数：pipeline  流程对象
+  *       index     阶段的序号
+  *       stats     保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t PipelineGetStageStats(const FvsPipeline_t pipeline, const FvsInt_t index,
+			FvsPipelineStats_t* stats);
+
+
+/******************************************************************************
+  * 功能：清零所有阶段的计时
+  * 参数：pipeline  流程对象
+  * 返回：无
+******************************************************************************/
+void PipelineResetStats(FvsPipeline_t pipeline);
+
+
+/******************************************************************************
+  * 功能：列出可用的阶段
+  * 参数：index     从0开始的序号
+  *       defaults  不为空时保存 FVS_PIPELINE_PARAMS 个缺省参数
+  *       count     不为空时保存参数个数
+  * 返回：阶段名，序号超出范围时返回空
+******************************************************************************/
+const char* PipelineGetStageType(const FvsInt_t index, FvsFloat_t* defaults,
+			FvsInt_t* count);
+
+
+#endif /* FVS__PIPELINE_HEADER__INCLUDED__ */
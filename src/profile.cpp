@@ -0,0 +1,145 @@
+
+/*#############################################################################
+ * 文件名：profile.cpp
+ * 功能：  处理流程各阶段的计时与计数
+#############################################################################*/
+
+#include <atomic>
+#include <chrono>
+
+#include "profile.h"
+
+
+/* 统计数据可能来自多个处理线程，全部使用原子变量 */
+typedef struct iFvsProfileStats_t {
+    std::atomic<FvsUint64_t>    calls;
+    std::atomic<FvsUint64_t>    nanoseconds;
+    std::atomic<FvsUint64_t>    pixels;
+    std::atomic<FvsUint64_t>    iterations;
+    std::atomic<FvsUint64_t>    items;
+} iFvsProfileStats_t;
+
+
+static std::atomic<bool> s_enabled(false);
+static iFvsProfileStats_t s_stats[FvsProfileStageCount];
+static FvsProfileHook_t s_hook = NULL;
+static FvsPointer_t s_context = NULL;
+
+static const char* s_names[FvsProfileStageCount] = {
+    "soften", "normalize", "direction", "frequency", "mask",
+    "enhance", "binarize", "thinning", "minutia"
+};
+
+
+/* 单调时钟，纳秒；加1保证启用时不会返回0 */
+static FvsUint64_t ProfileNow() {
+    return (FvsUint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count() + 1;
+}
+
+
+/******************************************************************************
+  * 功能：启用或关闭统计
+  * 参数：enable  FvsTrue 启用
+  * 返回：无
+******************************************************************************/
+void ProfileEnable(const FvsBool_t enable) {
+    s_enabled.store(enable == FvsTrue, std::memory_order_relaxed);
+}
+
+
+/******************************************************************************
+  * 功能：统计是否启用
+  * 参数：无
+  * 返回：启用返回true，否则返回false
+******************************************************************************/
+FvsBool_t ProfileIsEnabled() {
+    return s_enabled.load(std::memory_order_relaxed) ? FvsTrue : FvsFalse;
+}
+
+
+/******************************************************************************
+  * 功能：清零所有阶段的统计
+  * 参数：无
+  * 返回：无
+******************************************************************************/
+void ProfileReset() {
+    FvsInt_t i;
+    for (i = 0; i < FvsProfileStageCount; i++) {
+        s_stats[i].calls       = 0;
+        s_stats[i].nanoseconds = 0;
+        s_stats[i].pixels      = 0;
+        s_stats[i].iterations  = 0;
+        s_stats[i].items       = 0;
+    }
+}
+
+
+/******************************************************************************
+  * 功能：读取某个阶段的累计统计
+  * 参数：stage   阶段
+  *       stats   保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ProfileGetStats(const FvsProfileStage_t stage, FvsProfileStats_t* stats) {
+    if (stats == NULL || stage < 0 || stage >= FvsProfileStageCount)
+        return FvsBadParameter;
+    stats->calls       = s_stats[stage].calls;
+    stats->nanoseconds = s_stats[stage].nanoseconds;
+    stats->pixels      = s_stats[stage].pixels;
+    stats->iterations  = s_stats[stage].iterations;
+    stats->items       = s_stats[stage].items;
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：得到阶段的名字
+  * 参数：stage   阶段
+  * 返回：名字，阶段无效时返回空
+******************************************************************************/
+const char* ProfileGetStageName(const FvsProfileStage_t stage) {
+    if (stage < 0 || stage >= FvsProfileStageCount)
+        return NULL;
+    return s_names[stage];
+}
+
+
+/******************************************************************************
+  * 功能：设置导出回调，应在处理开始之前设置
+  * 参数：hook     回调函数，为空表示取消
+  *       context  传给回调的参数
+  * 返回：无
+******************************************************************************/
+void ProfileSetHook(FvsProfileHook_t hook, FvsPointer_t context) {
+    s_hook    = hook;
+    s_context = context;
+}
+
+
+FvsUint64_t ProfileBegin() {
+    if (!s_enabled.load(std::memory_order_relaxed))
+        return 0;
+    return ProfileNow();
+}
+
+
+void ProfileEnd(const FvsProfileStage_t stage, const FvsUint64_t start,
+                const FvsUint64_t pixels, const FvsUint64_t iterations,
+                const FvsUint64_t items) {
+    FvsProfileStats_t sample;
+    if (stage < 0 || stage >= FvsProfileStageCount)
+        return;
+    sample.calls       = 1;
+    sample.nanoseconds = ProfileNow() - start;
+    sample.pixels      = pixels;
+    sample.iterations  = iterations;
+    sample.items       = items;
+    s_stats[stage].calls       += sample.calls;
+    s_stats[stage].nanoseconds += sample.nanoseconds;
+    s_stats[stage].pixels      += sample.pixels;
+    s_stats[stage].iterations  += sample.iterations;
+    s_stats[stage].items       += sample.items;
+    if (s_hook != NULL)
+        s_hook(stage, &sample, s_context);
+}
@@ -0,0 +1,128 @@
+/*#############################################################################
+ * 文件名：profile.h
+ * 功能：  处理流程各阶段的计时与计数
+#############################################################################*/
+
+#if !defined FVS__PROFILE_HEADER__INCLUDED__
+#define FVS__PROFILE_HEADER__INCLUDED__
+
+/* 基本类型定义 */
+#include "fvstypes.h"
+
+
+/******************************************************************************
+  * 编译时定义 FVS_PROFILE 才会在库函数中插入计时代码，否则相关宏为空，
+  * 没有任何开销。即使编译了计时代码，也要调用 ProfileEnable 之后才会统计，
+  * 未启用时每次阶段调用只多一次标志判断。
+******************************************************************************/
+
+
+/* 被统计的处理阶段 */
+typedef enum FvsProfileStage_t
+{
+    FvsProfileSoften     = 0,	/* ImageSoftenMean          */
+    FvsProfileNormalize  = 1,	/* ImageNormalize           */
+    FvsProfileDirection  = 2,	/* FingerprintGetDirection  */
+    FvsProfileFrequency  = 3,	/* FingerprintGetFrequency* */
+    FvsProfileMask       = 4,	/* FingerprintGetMask       */
+    FvsProfileEnhance    = 5,	/* ImageEnhanceGabor        */
+    FvsProfileBinarize   = 6,	/* ImageBinarize            */
+    FvsProfileThinning   = 7,	/* ImageThin*               */
+    FvsProfileMinutia    = 8,	/* MinutiaSetExtract        */
+    FvsProfileStageCount = 9
+} FvsProfileStage_t;
+
+
+/* 一个阶段的统计结果 */
+typedef struct FvsProfileStats_t
+{
+    FvsUint64_t   calls;          /* 调用次数         */
+    FvsUint64_t   nanoseconds;    /* 墙上时间，纳秒   */
+    FvsUint64_t   pixels;         /* 处理的像素数     */
+    FvsUint64_t   iterations;     /* 迭代次数（细化） */
+    FvsUint64_t   items;          /* 输出个数（细节点）*/
+} FvsProfileStats_t;
+
+
+/******************************************************************************
+  * 功能：每个阶段结束时调用的回调，用于把数据导出到外部的监控系统。
+  *       sample 只包含本次调用的数据（calls 为1）。
+  *       回调可能在多个线程中同时被调用。
+******************************************************************************/
+typedef void (*FvsProfileHook_t)(const FvsProfileStage_t stage,
+			const FvsProfileStats_t* sample, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 功能：启用或关闭统计
+  * 参数：enable  FvsTrue 启用
+  * 返回：无
+******************************************************************************/
+void ProfileEnable(const FvsBool_t enable);
+
+
+/******************************************************************************
+  * 功能：统计是否启用
+  * 参数：无
+  * 返回：启用返回true，否则返回false
+******************************************************************************/
+FvsBool_t ProfileIsEnabled(void);
+
+
+/******************************************************************************
+  * 功能：清零所有阶段的统计
+  * 参数：无
+  * 返回：无
+******************************************************************************/
+void ProfileReset(void);
+
+
+/******************************************************************************
+  * 功能：读取某个阶段的累计统计
+  * 参数：stage   阶段
+  *       stats   保存结果
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t ProfileGetStats(const FvsProfileStage_t stage, FvsProfileStats_t* stats);
+
+
+/******************************************************************************
+  * 功能：得到阶段的名字
+  * 参数：stage   阶段
+  * 返回：名字，阶段无效时返回空
+******************************************************************************/
+const char* ProfileGetStageName(const FvsProfileStage_t stage);
+
+
+/******************************************************************************
+  * 功能：设置导出回调，应在处理开始之前设置
+  * 参数：hook     回调函数，为空表示取消
+  *       context  传给回调的参数
+  * 返回：无
+******************************************************************************/
+void ProfileSetHook(FvsProfileHook_t hook, FvsPointer_t context);
+
+
+/******************************************************************************
+  * 库内部使用：ProfileBegin 在未启用时返回0，
+  * ProfileEnd 把一次调用累加到阶段统计中并调用回调。
+******************************************************************************/
+FvsUint64_t ProfileBegin(void);
+
+void ProfileEnd(const FvsProfileStage_t stage, const FvsUint64_t start,
+			const FvsUint64_t pixels, const FvsUint64_t iterations,
+			const FvsUint64_t items);
+
+
+#if defined FVS_PROFILE
+#define FVS_PROFILE_BEGIN(t)    FvsUint64_t t = ProfileBegin()
+#define FVS_PROFILE_END(t, stage, pixels, iterations, items) \
+                if (t != 0) ProfileEnd(stage, t, (FvsUint64_t)(pixels), \
+                        (FvsUint64_t)(iterations), (FvsUint64_t)(items))
+#else
+#define FVS_PROFILE_BEGIN(t)
+#define FVS_PROFILE_END(t, stage, pixels, iterations, items)
+#endif
+
+
+#endif /* FVS__PROFILE_HEADER__INCLUDED__ */
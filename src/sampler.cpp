@@ -0,0 +1,197 @@
+
+/*#############################################################################
+ * 文件名：sampler.cpp
+ * 功能：  沿脊线方向的旋转采样
+#############################################################################*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sampler.h"
+
+
+#define SAMPLER_SHIFT   32
+#define SAMPLER_ONE     4294967296.0
+#define SAMPLER_MAXLEN  64
+
+
+/* 采样对象 */
+typedef struct iFvsSampler_t {
+    FvsInt_t    w, h;              /* 原图像的大小               */
+    FvsInt_t    margin;
+    FvsInt_t    pitch;             /* 加宽后的行宽 w + 2.margin  */
+    FvsInt_t    capacity;          /* 缓冲区的大小               */
+    FvsByte_t*  buffer;
+} iFvsSampler_t;
+
+
+/******************************************************************************
+  * 功能：创建一个采样对象
+  * 参数：无
+  * 返回：失败返回空，否则返回新的采样对象
+******************************************************************************/
+FvsSampler_t SamplerCreate() {
+    iFvsSampler_t* p = (iFvsSampler_t*)malloc(sizeof(iFvsSampler_t));
+    if (p != NULL) {
+        p->w        = 0;
+        p->h        = 0;
+        p->margin   = 0;
+        p->pitch    = 0;
+        p->capacity = 0;
+        p->buffer   = NULL;
+    }
+    return (FvsSampler_t)p;
+}
+
+
+/******************************************************************************
+  * 功能：销毁一个采样对象
+  * 参数：sampler  采样对象
+  * 返回：无
+******************************************************************************/
+void SamplerDestroy(FvsSampler_t sampler) {
+    iFvsSampler_t* p = (iFvsSampler_t*)sampler;
+    if (p == NULL)
+        return;
+    free(p->buffer);
+    free(p);
+}
+
+
+/******************************************************************************
+  * 功能：设置采样的图像，复制到加宽的缓冲区中
+  * 参数：sampler  采样对象
+  *       image    图像
+  *       margin   四周加宽的象素数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerSetImage(FvsSampler_t sampler, const FvsImage_t image,
+                           const FvsInt_t margin) {
+    iFvsSampler_t* p = (iFvsSampler_t*)sampler;
+    FvsInt_t w      = ImageGetWidth (image);
+    FvsInt_t h      = ImageGetHeight(image);
+    FvsInt_t pitchi = ImageGetPitch (image);
+    FvsByte_t* src  = ImageGetBuffer(image);
+    FvsInt_t pitch, size, x, y;
+    FvsByte_t* row;
+    if (p == NULL || src == NULL || w <= 0 || h <= 0)
+        return FvsMemory;
+    if (margin < 0)
+        return FvsBadParameter;
+    pitch = w + 2 * margin;
+    size  = pitch * (h + 2 * margin);
+    if (size > p->capacity) {
+        free(p->buffer);
+        p->capacity = 0;
+        p->buffer   = (FvsByte_t*)malloc((size_t)size);
+        if (p->buffer == NULL)
+            return FvsMemory;
+        p->capacity = size;
+    }
+    p->w      = w;
+    p->h      = h;
+    p->margin = margin;
+    p->pitch  = pitch;
+    /* 中间各行，左右重复边缘象素 */
+    for (y = 0; y < h; y++) {
+        row = p->buffer + (y + margin) * pitch;
+        memcpy(row + margin, src + y * pitchi, (size_t)w);
+        for (x = 0; x < margin; x++) {
+            row[x] = src[y * pitchi];
+            row[margin + w + x] = src[y * pitchi + w - 1];
+        }
+    }
+    /* 上下重复边缘的行 */
+    for (y = 0; y < margin; y++) {
+        memcpy(p->buffer + y * pitch, p->buffer + margin * pitch, (size_t)pitch);
+        memcpy(p->buffer + (margin + h + y) * pitch,
+               p->buffer + (margin + h - 1) * pitch, (size_t)pitch);
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：累加旋转网格中 d = first .. last-1 的采样值
+  * 参数：sampler         采样对象
+  *       x, y            网格中心
+  *       cosdir, sindir  网格方向
+  *       length, width   网格大小
+  *       first, last     累加的 d 的范围
+  *       sums            length 个累加值
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerAccumulate(const FvsSampler_t sampler, const FvsInt_t x,
+                             const FvsInt_t y, const FvsFloat_t cosdir,
+                             const FvsFloat_t sindir, const FvsInt_t length,
+                             const FvsInt_t width, const FvsInt_t first,
+                             const FvsInt_t last, FvsInt_t* sums) {
+    const iFvsSampler_t* p = (const iFvsSampler_t*)sampler;
+    const FvsByte_t* buffer;
+    FvsInt64_t c, s, u0, v0, u, v;
+    FvsInt_t pitch, k, d, sum;
+    FvsFloat_t half;
+    if (p == NULL || p->buffer == NULL || sums == NULL)
+        return FvsMemory;
+    if (x < 0 || x >= p->w || y < 0 || y >= p->h ||
+            first < 0 || last > width || length <= 0)
+        return FvsBadParameter;
+    /* 网格的半对角线加上取整的一个象素必须在加宽的范围之内 */
+    half = sqrt((FvsFloat_t)(length * length + width * width)) / 2.0 + 1.0;
+    if (half > p->margin)
+        return FvsBadParameter;
+    if (first >= last)
+        return FvsOK;
+    pitch  = p->pitch;
+    buffer = p->buffer;
+    c = (FvsInt64_t)floor(cosdir * SAMPLER_ONE + 0.5);
+    s = (FvsInt64_t)floor(sindir * SAMPLER_ONE + 0.5);
+    /* 网格 (0, first) 点的定点坐标，加宽后都是正数。从中心整数点出发
+       用整数步长推算，网格中心落在整数点上，不受步长舍入的影响 */
+    u0 = ((FvsInt64_t)(x + p->margin) << SAMPLER_SHIFT) - (length / 2) * c - (first - width / 2) * s;
+    v0 = ((FvsInt64_t)(y + p->margin) << SAMPLER_SHIFT) - (length / 2) * s + (first - width / 2) * c;
+    for (k = 0; k < length; k++) {
+        u   = u0;
+        v   = v0;
+        sum = 0;
+        for (d = first; d < last; d++) {
+            sum += buffer[(FvsInt_t)(v >> SAMPLER_SHIFT) * pitch + (FvsInt_t)(u >> SAMPLER_SHIFT)];
+            u -= s;
+            v += c;
+        }
+        sums[k] += sum;
+        u0 += c;
+        v0 += s;
+    }
+    return FvsOK;
+}
+
+
+/******************************************************************************
+  * 功能：计算 x-signature，即旋转网格每一行的平均值
+  * 参数：sampler         采样对象
+  *       x, y            网格中心
+  *       cosdir, sindir  网格方向
+  *       length, width   网格大小
+  *       signature       输出 length 个平均值
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerSignature(const FvsSampler_t sampler, const FvsInt_t x,
+                            const FvsInt_t y, const FvsFloat_t cosdir,
+                            const FvsFloat_t sindir, const FvsInt_t length,
+                            const FvsInt_t width, FvsFloat_t* signature) {
+    FvsInt_t sums[SAMPLER_MAXLEN];
+    FvsError_t nRet;
+    FvsInt_t k;
+    if (length > SAMPLER_MAXLEN || width <= 0)
+        return FvsBadParameter;
+    memset(sums, 0, (size_t)length * sizeof(FvsInt_t));
+    nRet = SamplerAccumulate(sampler, x, y, cosdir, sindir, length, width,
+                             0, width, sums);
+    if (nRet != FvsOK)
+        return nRet;
+    for (k = 0; k < length; k++)
+        signature[k] = (FvsFloat_t)sums[k] / width;
+    return FvsOK;
+}
@@ -0,0 +1,90 @@
+/*#############################################################################
+ * 文件名：sampler.h
+ * 功能：  沿脊线方向的旋转采样
+#############################################################################*/
+
+#if !defined FVS__SAMPLER_HEADER__INCLUDED__
+#define FVS__SAMPLER_HEADER__INCLUDED__
+
+#include "image.h"
+
+
+/******************************************************************************
+** 采样对象保存一个四周加宽 margin 个象素的图像副本，加宽的部分重复边缘的
+** 象素，所以采样时不需要再逐点截断坐标，结果与截断到图像边缘相同。
+**
+** 旋转的采样网格用64位定点数（32位小数）沿两个基向量递推生成：
+**   u = x + (k - length/2).cos - (d - width/2).sin
+**   v = y + (k - length/2).sin + (d - width/2).cos
+** k = 0 .. length-1 沿方向 (cos,sin)，d = 0 .. width-1 沿其法线，
+** 每个采样点只需要两次加法，不再做浮点运算和类型转换。
+** 网格的半对角线加1不能超过 margin，坐标必须在图像之内。
+**
+** 设置图像之后采样是只读的，多个线程可以同时使用同一个对象。
+******************************************************************************/
+
+/* 对象的这些接口实现是私有的，不必为用户所知 */
+typedef FvsHandle_t FvsSampler_t;
+
+
+/******************************************************************************
+  * 功能：创建一个采样对象
+  * 参数：无
+  * 返回：失败返回空，否则返回新的采样对象
+******************************************************************************/
+FvsSampler_t SamplerCreate();
+
+
+/******************************************************************************
+  * 功能：销毁一个采样对象
+  * 参数：sampler  采样对象
+  * 返回：无
+******************************************************************************/
+void SamplerDestroy(FvsSampler_t sampler);
+
+
+/******************************************************************************
+  * 功能：设置采样的图像，复制到加宽的缓冲区中
+  * 参数：sampler  采样对象
+  *       image    图像
+  *       margin   四周加宽的象素数
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerSetImage(FvsSampler_t sampler, const FvsImage_t image,
+                           const FvsInt_t margin);
+
+
+/******************************************************************************
+  * 功能：累加旋转网格中 d = first .. last-1 的采样值，
+  *       sums[k] 加上第 k 行的和，sums 不先清零
+  * 参数：sampler         采样对象
+  *       x, y            网格中心
+  *       cosdir, sindir  网格方向
+  *       length, width   网格大小
+  *       first, last     累加的 d 的范围
+  *       sums            length 个累加值
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerAccumulate(const FvsSampler_t sampler, const FvsInt_t x,
+                             const FvsInt_t y, const FvsFloat_t cosdir,
+                             const FvsFloat_t sindir, const FvsInt_t length,
+                             const FvsInt_t width, const FvsInt_t first,
+                             const FvsInt_t last, FvsInt_t* sums);
+
+
+/******************************************************************************
+  * 功能：计算 x-signature，即旋转网格每一行（宽度方向）的平均值
+  * 参数：sampler         采样对象
+  *       x, y            网格中心
+  *       cosdir, sindir  网格方向
+  *       length, width   网格大小
+  *       signature       输出 length 个平均值
+  * 返回：错误编号
+******************************************************************************/
+FvsError_t SamplerSignature(const FvsSampler_t sampler, const FvsInt_t x,
+                            const FvsInt_t y, const FvsFloat_t cosdir,
+                            const FvsFloat_t sindir, const FvsInt_t length,
+                            const FvsInt_t width, FvsFloat_t* signature);
+
+
+#endif /* FVS__SAMPLER_HEADER__INCLUDED__ */
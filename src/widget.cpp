@@ -6,9 +6,12 @@ static FvsError_t OverlayDirection(FvsImage_t image, const FvsFloatField_t field
     FvsInt_t w      = ImageGetWidth (image);
     FvsInt_t h      = ImageGetHeight(image);
     FvsInt_t pitch, dirp;
-    FvsFloat_t theta, c, s;
+    FvsFloat_t c, s;
     FvsByte_t* p;
-    FvsFloat_t* orientation;
+    FvsFieldFloat_t* orientation;
+    const FvsFloat_t* cosTable;
+    const FvsFloat_t* sinTable;
+    FvsByte_t level;
     FvsInt_t x, y, size, i, j, l;
     size = 8;
     (void)ImageLuminosity(image, 168);
@@ -18,11 +21,12 @@ static FvsError_t OverlayDirection(FvsImage_t image, const FvsFloatField_t field
     dirp        = FloatFieldGetPitch(field);
     if (p == NULL || orientation == NULL)
         return FvsMemory;
+    OrientationGetTables(&cosTable, &sinTable);
     for (y = size; y < h - size; y += size - 2)
         for (x = size; x < w - size; x += size - 2) {
-            theta = orientation[x + y * dirp];
-            c = cos(theta);
-            s = sin(theta);
+            level = OrientationQuantize(orientation[x + y * dirp]);
+            c = cosTable[level];
+            s = sinTable[level];
             for (l = 0; l < size; l++) {
                 i = (FvsInt_t)(x + size / 2 - l * s);
                 j = (FvsInt_t)(y + size / 2 + l * c);
@@ -33,17 +37,59 @@ static FvsError_t OverlayDirection(FvsImage_t image, const FvsFloatField_t field
 }
 
 
+/* wrap an 8-bit fvs image into a QImage without going through a bmp file */
+static QImage FvsImageToQImage(const FvsImage_t image) {
+    QVector<QRgb> grayTable(256);
+    for (int i = 0; i < 256; i++)
+        grayTable[i] = qRgb(i, i, i);
+    QImage view((const uchar *)ImageGetBuffer(image), ImageGetWidth(image),
+                 ImageGetHeight(image), ImageGetPitch(image), QImage::Format_Indexed8);
+    view.setColorTable(grayTable);
+    /* the pipeline keeps working in place on the buffer, detach before posting */
+    return view.copy();
+}
+
+/* the batch keeps the fused 1-bit chain; each stage runs on its own threads */
+static const char *batchDescription =
+    "soften-normalize(3,100,10000) direction(7,8) frequency1 mask "
+    "gabor-binarize-bits(4,128) thin-hitmiss-bits minutia-bits";
+
+
 Widget::Widget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::Widget) {
     ui->setupUi(this);
     setFixedSize(this->width(), this->height());
     ui->scrollArea->setWidgetResizable(true);
+    mainProThread = new ProThread("", false, 4.0);
+    connect(mainProThread, SIGNAL(stageReady(int, QImage)), this, SLOT(showStage(int, QImage)));
+    connect(mainProThread, SIGNAL(stageTimes(QString)), this, SLOT(showTimes(QString)));
+    connect(mainProThread, SIGNAL(failed(QString)), this, SLOT(processFailed(QString)));
+    connect(mainProThread, SIGNAL(finished()), this, SLOT(processFinished()));
     connect(ui->pushButton_openFile, SIGNAL(clicked()), this, SLOT(openFile()));
     connect(ui->pushButton_Process, SIGNAL(clicked()), this, SLOT(processImage()));
+    ui->lineEdit_pipeline->setText(mainProThread->pipelineDescription());
+    batchPending = 0;
+    batchRunning = false;
+    batchPipeline = PipelineCreate();
+    PipelineParse(batchPipeline, batchDescription);
+    batch = BatchCreate(batchPipeline, 1200);
+    connect(ui->pushButton_batchFolder, SIGNAL(clicked()), this, SLOT(chooseBatchFolder()));
+    connect(ui->pushButton_batchFiles, SIGNAL(clicked()), this, SLOT(chooseBatchFiles()));
+    connect(ui->pushButton_batchRun, SIGNAL(clicked()), this, SLOT(runBatch()));
+    connect(ui->pushButton_batchStop, SIGNAL(clicked()), this, SLOT(stopBatch()));
 }
 
 Widget::~Widget() {
+    mainProThread->cancel();
+    batchCancel.fetchAndStoreOrdered(1);
+    mainProThread->wait();
+    BatchCancel(batch);
+    batchPool.waitForDone();
+    delete mainProThread;
+    clearBatch();
+    BatchDestroy(batch);
+    PipelineDestroy(batchPipeline);
     delete ui;
 }
 
@@ -58,107 +104,403 @@ void Widget::processImage() {
         QMessageBox::information(NULL, "Error", "Please select a bmp file!");
         return;
     }
-    mainProThread = new ProThread(filename, true, 4.0);
-    mainProThread->setPicLabel(ui->label_origin, ui->label_direction, ui->label_mask, ui->label_enhance, ui->label_binarize, ui->label_thinning, ui->label_minutia);
+    if(mainProThread->isRunning()) {
+        /* restart with the latest file once the current run has stopped */
+        pendingFile = filename;
+        pendingPipeline = ui->lineEdit_pipeline->text();
+        mainProThread->cancel();
+        return;
+    }
+    if(!mainProThread->setPipeline(ui->lineEdit_pipeline->text())) {
+        QMessageBox::information(this, "Error", "Bad processing pipeline!");
+        return;
+    }
+    ui->label_timing->clear();
+    mainProThread->setFile(filename);
     mainProThread->start();
 }
 
-ProThread::ProThread(QString file, bool gen = false, double r = 4.0) {
-    minutiaSet = MinutiaSetCreate(ProThread::defaultSetSize);
-    bmpfilename = file;
-    genPic = gen;
-    radius = r;
+void Widget::processFinished() {
+    if(pendingFile == "")
+        return;
+    mainProThread->setFile(pendingFile);
+    pendingFile = "";
+    if(!mainProThread->setPipeline(pendingPipeline)) {
+        QMessageBox::information(this, "Error", "Bad processing pipeline!");
+        return;
+    }
+    ui->label_timing->clear();
+    mainProThread->start();
 }
 
-void ProThread::setPicLabel(QLabel *ori, QLabel *direc, QLabel *mas, QLabel *enhan, QLabel *bin, QLabel *thin, QLabel *minu) {
-    originLabel = ori;
-    directionLabel = direc;
-    maskLabel = mas;
-    enhanceLabel = enhan;
-    binarizeLabel = bin;
-    thinningLabel = thin;
-    minutiaLabel = minu;
+void Widget::processFailed(const QString &message) {
+    QMessageBox::information(this, "Error", message);
 }
 
-void ProThread::run() {
-    QPixmap tempPic;
-    QString tname;
-    FvsImage_t mask;
-    FvsImage_t image;
-    FvsImage_t directionimage;
-    FvsMinutiaSet_t minutia = minutiaSet;
-    FvsFloatField_t direction;
-    FvsFloatField_t frequency;
+void Widget::showStage(int stage, const QImage &image) {
+    QLabel *label;
+    switch(stage) {
+        case StageOrigin:
+            label = ui->label_origin;
+            break;
+        case StageDirection:
+            label = ui->label_direction;
+            break;
+        case StageMask:
+            label = ui->label_mask;
+            break;
+        case StageEnhance:
+            label = ui->label_enhance;
+            break;
+        case StageBinarize:
+            label = ui->label_binarize;
+            break;
+        case StageThinning:
+            label = ui->label_thinning;
+            break;
+        case StageMinutia:
+            label = ui->label_minutia;
+            break;
+        default:
+            return;
+    }
+    label->setPixmap(QPixmap::fromImage(image));
+}
+
+void Widget::showTimes(const QString &text) {
+    ui->label_timing->setText(text);
+}
+
+void Widget::chooseBatchFolder() {
+    QString dir = QFileDialog::getExistingDirectory(this, "Open bmp folder", QDir::currentPath());
+    if(dir == "")
+        return;
+    QDir folder(dir);
+    QStringList names = folder.entryList(QStringList() << "*.bmp", QDir::Files, QDir::Name);
+    batchFiles.clear();
+    for(int i = 0; i < names.size(); i++)
+        batchFiles << folder.absoluteFilePath(names[i]);
+    ui->lineEdit_batchPath->setText(dir);
+}
+
+void Widget::chooseBatchFiles() {
+    QStringList files = QFileDialog::getOpenFileNames(this, "Open bmp Images", QDir::currentPath(), "BMP files(*.bmp)");
+    if(files.isEmpty())
+        return;
+    batchFiles = files;
+    ui->lineEdit_batchPath->setText(files.join(";"));
+}
+
+void Widget::clearBatch() {
+    for(int i = 0; i < batchSets.size(); i++)
+        MinutiaSetDestroy(batchSets[i]);
+    batchSets.clear();
+}
+
+void Widget::runBatch() {
+    int n = batchFiles.size();
+    if(batchRunning)
+        return;
+    if(n < 2) {
+        QMessageBox::information(this, "Error", "Please select a folder or at least two bmp files!");
+        return;
+    }
+    clearBatch();
+    batchSets.resize(n);
+    for(int i = 0; i < n; i++)
+        batchSets[i] = MinutiaSetCreate(1200);
+    batchScores.fill(-1, n * n);
+    batchRunning = true;
+    batchCancel.fetchAndStoreOrdered(0);
+    QStringList headers;
+    for(int i = 0; i < n; i++)
+        headers << QFileInfo(batchFiles[i]).fileName();
+    ui->tableWidget_scores->clear();
+    ui->tableWidget_scores->setRowCount(n);
+    ui->tableWidget_scores->setColumnCount(n);
+    ui->tableWidget_scores->setHorizontalHeaderLabels(headers);
+    ui->tableWidget_scores->setVerticalHeaderLabels(headers);
+    ui->plainTextEdit_batchLog->clear();
+    ui->progressBar_batch->setRange(0, n + n);
+    ui->progressBar_batch->setValue(0);
+    ui->pushButton_batchRun->setEnabled(false);
+    ui->pushButton_batchStop->setEnabled(true);
+    batchClock.start();
+    /* spread the threads by the stage times of the previous run, evenly on the first */
+    BatchBalance(batch, 0);
+    batchPool.start(new BatchTask(this, batch, batchFiles, batchSets));
+}
+
+void Widget::stopBatch() {
+    batchCancel.fetchAndStoreOrdered(1);
+    BatchCancel(batch);
+}
+
+void Widget::batchImageDone(int index, bool ok, const QString &times) {
+    QString line = QFileInfo(batchFiles[index]).fileName() + ":";
+    if(ok)
+        line += times + QString(", %1 minutiae").arg(MinutiaSetGetCount(batchSets[index]));
+    else
+        line += " failed";
+    ui->plainTextEdit_batchLog->appendPlainText(line);
+    ui->progressBar_batch->setValue(ui->progressBar_batch->value() + 1);
+}
+
+void Widget::batchRunDone(const QString &summary) {
+    ui->plainTextEdit_batchLog->appendPlainText(summary);
+    if(batchCancel.fetchAndAddOrdered(0) != 0)
+        finishBatch();
+    else
+        startMatching();
+}
+
+void Widget::startMatching() {
+    int n = batchSets.size();
+    /* the images that were not loaded count as done */
+    ui->progressBar_batch->setValue(n);
+    batchPending = n;
+    batchPool.start(new MatchTask(this, batchSets, batchScores.data(), &batchCancel));
+}
+
+void Widget::batchMatchDone(int row) {
+    int n = batchSets.size();
+    for(int j = 0; j < n; j++) {
+        int score = batchScores[row * n + j];
+        QString text = (score < 0) ? QString("-") : QString::number(score);
+        ui->tableWidget_scores->setItem(row, j, new QTableWidgetItem(text));
+    }
+    ui->progressBar_batch->setValue(ui->progressBar_batch->value() + 1);
+    if(--batchPending == 0)
+        finishBatch();
+}
+
+void Widget::finishBatch() {
+    batchRunning = false;
+    ui->pushButton_batchRun->setEnabled(true);
+    ui->pushButton_batchStop->setEnabled(false);
+    ui->plainTextEdit_batchLog->appendPlainText(QString("%1 images, %2 ms on %3 threads%4")
+            .arg(batchSets.size()).arg(batchClock.elapsed()).arg(ParallelGetThreadCount())
+            .arg(batchCancel.fetchAndAddOrdered(0) != 0 ? ", cancelled" : ""));
+}
+
+BatchTask::BatchTask(QObject *r, FvsBatch_t b, const QStringList &f, const QVector<FvsMinutiaSet_t> &s) {
+    receiver = r;
+    batch = b;
+    files = f;
+    sets = s;
+}
+
+void BatchTask::run() {
+    FvsBatchStats_t stats;
+    QString summary = "stages:";
+    FvsError_t nRet = BatchRun(batch, files.size(), BatchTask::load, BatchTask::store, this);
+    for(int s = 0; s < BatchGetStageCount(batch); s++) {
+        BatchGetStageStats(batch, s, &stats);
+        summary += QString(" %1 x%2 queue %3/%4").arg(BatchGetStageName(batch, s)).arg(stats.threads)
+                   .arg(stats.meanDepth, 0, 'f', 1).arg(stats.maxDepth);
+    }
+    if(nRet != FvsOK && nRet != FvsFailure)
+        summary += QString(", error %1").arg((int)nRet);
+    QMetaObject::invokeMethod(receiver, "batchRunDone", Qt::QueuedConnection, Q_ARG(QString, summary));
+}
+
+/* stage 0 of the executor */
+FvsError_t BatchTask::load(const FvsInt_t index, FvsPipelineData_t *data, FvsPointer_t context) {
+    BatchTask *task = (BatchTask *)context;
+    QByteArray name = task->files[index].toLatin1();
     FvsByte_t bmfh[14];
     BITMAPINFOHEADER bmih;
     RGBQUAD rgbq[256];
-    char *orifilename = bmpfilename.toLatin1().data();
-    char *fname;
+    return FvsImageImport(data->image, name.data(), bmfh, &bmih, rgbq);
+}
+
+/* after the last stage; the buffer is reused once this returns */
+void BatchTask::store(const FvsInt_t index, const FvsError_t result, FvsPipelineData_t *data,
+                      const FvsUint64_t *times, FvsPointer_t context) {
+    BatchTask *task = (BatchTask *)context;
+    FvsMinutiaSet_t minutia = task->sets[index];
+    FvsMinutia_t *p = MinutiaSetGetBuffer(data->minutia);
+    QString text;
+    MinutiaSetEmpty(minutia);
+    for(int i = 0; result == FvsOK && i < MinutiaSetGetCount(data->minutia); i++)
+        MinutiaSetAdd(minutia, p[i].x, p[i].y, p[i].type, p[i].angle);
+    for(int s = 0; s < BatchGetStageCount(task->batch); s++)
+        text += QString(" %1 %2ms").arg(BatchGetStageName(task->batch, s)).arg((int)(times[s] / 1000000));
+    QMetaObject::invokeMethod(task->receiver, "batchImageDone", Qt::QueuedConnection,
+                              Q_ARG(int, index), Q_ARG(bool, result == FvsOK), Q_ARG(QString, text));
+}
+
+MatchTask::MatchTask(QObject *r, const QVector<FvsMinutiaSet_t> &s, int *sc, QAtomicInt *c) {
+    receiver = r;
+    sets = s;
+    scores = sc;
+    cancel = c;
+}
+
+void MatchTask::run() {
+    /* failed images have empty sets and score -1 */
+    MatchingCompareMany(sets.constData(), sets.size(), scores, MatchTask::rowDone, this);
+}
+
+/* called on the library's worker threads */
+FvsBool_t MatchTask::rowDone(const FvsInt_t row, FvsPointer_t context) {
+    MatchTask *task = (MatchTask *)context;
+    QMetaObject::invokeMethod(task->receiver, "batchMatchDone", Qt::QueuedConnection, Q_ARG(int, row));
+    return (task->cancel->fetchAndAddOrdered(0) == 0) ? FvsTrue : FvsFalse;
+}
+
+/* %1 is the Gabor radius */
+const char *ProThread::defaultPipeline =
+    "soften-normalize(3,100,10000) enhance-tiled(%1) binarize(128) thin-hitmiss minutia";
+
+/* gen: also export every intermediate image as a bmp next to the input file */
+ProThread::ProThread(QString file, bool gen = false, double r = 4.0) {
+    minutiaSet = MinutiaSetCreate(ProThread::defaultSetSize);
     mask = ImageCreate();
     image = ImageCreate();
-    directionimage = ImageCreate();
+    viewimage = ImageCreate();
+    bits = BitImageCreate();
     direction = FloatFieldCreate();
     frequency = FloatFieldCreate();
-    if(FvsOK != FvsImageImport(image, orifilename, bmfh, &bmih, rgbq)) {
-        QMessageBox::information(NULL, "Error", "BMP file error!");
+    pipeline = PipelineCreate();
+    PipelineSetCancel(pipeline, ProThread::pipelineCancelled, this);
+    bmpfilename = file;
+    genPic = gen;
+    radius = r;
+    doneStages = 0;
+    /* FVS_PIPELINE picks other algorithms without rebuilding, see pipeline.h */
+    QByteArray custom = qgetenv("FVS_PIPELINE");
+    if(custom.isEmpty() || !setPipeline(QString::fromLatin1(custom.constData())))
+        setPipeline(QString(ProThread::defaultPipeline).arg(radius));
+}
+
+ProThread::~ProThread() {
+    MinutiaSetDestroy(minutiaSet);
+    ImageDestroy(mask);
+    ImageDestroy(image);
+    ImageDestroy(viewimage);
+    BitImageDestroy(bits);
+    FloatFieldDestroy(direction);
+    FloatFieldDestroy(frequency);
+    PipelineDestroy(pipeline);
+}
+
+/* only valid while the thread is not running */
+void ProThread::setFile(const QString &file) {
+    bmpfilename = file;
+    cancelFlag.fetchAndStoreOrdered(0);
+}
+
+/* only valid while the thread is not running, returns false for a bad description */
+bool ProThread::setPipeline(const QString &text) {
+    QByteArray latin = text.toLatin1();
+    if(PipelineParse(pipeline, latin.data()) != FvsOK || PipelineGetStageCount(pipeline) == 0) {
+        PipelineParse(pipeline, description.toLatin1().data());
+        return false;
+    }
+    description = text.simplified();
+    return true;
+}
+
+QString ProThread::pipelineDescription() const {
+    return description;
+}
+
+/* ask a running pipeline to stop at the next stage boundary, or the next tile of enhance-tiled */
+void ProThread::cancel() {
+    cancelFlag.fetchAndStoreOrdered(1);
+}
+
+bool ProThread::isCancelled() {
+    return cancelFlag.fetchAndAddOrdered(0) != 0;
+}
+
+/* called by the pipeline between stages and tiles, possibly on the library's worker threads */
+FvsBool_t ProThread::pipelineCancelled(FvsPointer_t context) {
+    return ((ProThread *)context)->isCancelled() ? FvsTrue : FvsFalse;
+}
+
+void ProThread::publish(PipelineStage stage, const FvsImage_t image, const char *suffix) {
+    emit stageReady(stage, FvsImageToQImage(image));
+    if(genPic && suffix != NULL) {
+        QByteArray fname = (bmpfilename + suffix).toLatin1();
+        FvsImageExport(image, fname.data(), bmfh, &bmih, rgbq);
+    }
+}
+
+void ProThread::run() {
+    QByteArray orifilename = bmpfilename.toLatin1();
+    FvsPipelineData_t data;
+    FvsError_t nRet;
+    if(FvsOK != FvsImageImport(image, orifilename.data(), bmfh, &bmih, rgbq)) {
+        emit failed("BMP file error!");
+        return;
+    }
+    publish(StageOrigin, image, NULL);
+    data.image     = image;
+    data.direction = direction;
+    data.frequency = frequency;
+    data.mask      = mask;
+    data.bits      = bits;
+    data.minutia   = minutiaSet;
+    doneStages     = 0;
+    nRet = PipelineRun(pipeline, &data, ProThread::stageDone, this);
+    if(nRet == FvsFailure)
+        return;
+    if(nRet != FvsOK) {
+        emit failed(QString("Stage %1 failed (error %2)!")
+                    .arg(PipelineGetStageName(pipeline, doneStages)).arg((int)nRet));
         return;
     }
-    tempPic.load(orifilename);
-    originLabel->setPixmap(tempPic);
-    FvsInt_t w  = ImageGetWidth (image);
-    FvsInt_t h  = ImageGetHeight(image);
-    ImageSetSize(directionimage, w, h);
-    ImageSoftenMean(image, 3);
-    ImageNormalize(image, 100, 10000);
-    FingerprintGetDirection(image, direction, 7, 8);
-    FingerprintGetFrequency1(image, direction, frequency);
-    FingerprintGetMask(image, direction, frequency, mask);
-    ImageEnhanceGabor(image, direction, frequency, mask, radius);
-    OverlayDirection(directionimage, direction);
-    //saving file....
-    if(genPic) {
-        tname = bmpfilename + "_dir.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(directionimage, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        directionLabel->setPixmap(tempPic);
-        tname = bmpfilename + "_mask.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(mask, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        maskLabel->setPixmap(tempPic);
-        tname = bmpfilename + "_enh.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(image, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        enhanceLabel->setPixmap(tempPic);
-    }
-    ImageBinarize(image, (FvsByte_t)0x80);
-    if(genPic) {
-        tname = bmpfilename + "_bin.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(image, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        binarizeLabel->setPixmap(tempPic);
-    }
-    ImageThinHitMiss(image);
-    if(genPic) {
-        tname = bmpfilename + "_thin.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(image, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        thinningLabel->setPixmap(tempPic);
-    }
-    MinutiaSetExtract(minutia, image, direction, mask);
-    if(genPic) {
-        ImageClear(image);
-        MinutiaSetDraw(minutia, image);
-        tname = bmpfilename + "_minu.bmp";
-        fname = tname.toLatin1().data();
-        FvsImageExport(image, fname, bmfh, &bmih, rgbq);
-        tempPic.load(fname);
-        minutiaLabel->setPixmap(tempPic);
-    }
-    //QMessageBox::information(NULL,"Done","Complete!");
+    QString text;
+    FvsPipelineStats_t stats;
+    for(int i = 0; i < PipelineGetStageCount(pipeline); i++) {
+        PipelineGetStageStats(pipeline, i, &stats);
+        text += QString("%1%2 %3ms").arg(i == 0 ? "" : ", ")
+                .arg(PipelineGetStageName(pipeline, i)).arg(stats.last / 1000000.0, 0, 'f', 1);
+    }
+    emit stageTimes(text);
 }
 
+/* called by the pipeline after every stage, on the worker thread */
+FvsBool_t ProThread::stageDone(const FvsInt_t index, const char *name,
+                               FvsPipelineData_t *data, FvsPointer_t context) {
+    ProThread *thread = (ProThread *)context;
+    (void)name;
+    thread->doneStages = index + 1;
+    thread->publishOutputs(PipelineGetStageOutputs(thread->pipeline, index), data);
+    return thread->isCancelled() ? FvsFalse : FvsTrue;
+}
+
+/* show whatever the last stage produced, in the order of the labels */
+void ProThread::publishOutputs(FvsUint_t outputs, FvsPipelineData_t *data) {
+    FvsInt_t w = ImageGetWidth(data->image);
+    FvsInt_t h = ImageGetHeight(data->image);
+    FvsImage_t shown = data->image;
+    if(outputs & FvsPipelineDirection) {
+        /* viewimage still holds the previous overlay, bit image or minutiae */
+        ImageSetSize(viewimage, w, h);
+        ImageClear(viewimage);
+        OverlayDirection(viewimage, data->direction);
+        publish(StageDirection, viewimage, "_dir.bmp");
+    }
+    if(outputs & FvsPipelineMask)
+        publish(StageMask, data->mask, "_mask.bmp");
+    if(outputs & FvsPipelineBits) {
+        /* the 1-bit stages leave the gray image alone */
+        BitImageToImage(viewimage, data->bits);
+        shown = viewimage;
+    }
+    if(outputs & FvsPipelineEnhanced)
+        publish(StageEnhance, shown, "_enh.bmp");
+    if(outputs & FvsPipelineBinarized)
+        publish(StageBinarize, shown, "_bin.bmp");
+    if(outputs & FvsPipelineThinned)
+        publish(StageThinning, shown, "_thin.bmp");
+    if(outputs & FvsPipelineMinutia) {
+        ImageSetSize(viewimage, w, h);
+        ImageClear(viewimage);
+        MinutiaSetDraw(data->minutia, viewimage);
+        publish(StageMinutia, viewimage, "_minu.bmp");
+    }
+}
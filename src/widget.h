@@ -7,6 +7,14 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QPixmap>
+#include <QImage>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QStringList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QFileInfo>
 
 #include "fvs.h"
 
@@ -16,6 +24,17 @@ namespace Ui {
     class Widget;
 }
 
+/* stages of the processing pipeline that can be shown in the UI */
+enum PipelineStage {
+    StageOrigin = 0,
+    StageDirection,
+    StageMask,
+    StageEnhance,
+    StageBinarize,
+    StageThinning,
+    StageMinutia
+};
+
 class Widget : public QWidget
 {
     Q_OBJECT
@@ -26,11 +45,70 @@ public:
 
 private:
     Ui::Widget *ui;
-    QString filename,filename1,filename2;
-    ProThread *mainProThread,*matchThread1,*matchThread2;
+    QString filename;
+    ProThread *mainProThread;
 private slots:
     void openFile();
     void processImage();
+    void processFinished();
+    void processFailed(const QString &message);
+    void showStage(int stage, const QImage &image);
+    void showTimes(const QString &text);
+    void chooseBatchFolder();
+    void chooseBatchFiles();
+    void runBatch();
+    void stopBatch();
+    void batchImageDone(int index, bool ok, const QString &times);
+    void batchRunDone(const QString &summary);
+    void batchMatchDone(int row);
+private:
+    void clearBatch();
+    void startMatching();
+    void finishBatch();
+    QString pendingFile;
+    QString pendingPipeline;
+    /* batch mode: one minutia set per image, scores[i*n+j] = match(i, j) */
+    QStringList batchFiles;
+    QVector<FvsMinutiaSet_t> batchSets;
+    QVector<int> batchScores;
+    int batchPending;
+    bool batchRunning;
+    QAtomicInt batchCancel;
+    QElapsedTimer batchClock;
+    QThreadPool batchPool;
+    /* kept between runs so that BatchBalance can use the last timings */
+    FvsPipeline_t batchPipeline;
+    FvsBatch_t batch;
+};
+
+
+/* extracts the minutiae of all batch images, one executor stage per pipeline stage */
+class BatchTask:public QRunnable{
+public:
+    BatchTask(QObject *,FvsBatch_t,const QStringList &,const QVector<FvsMinutiaSet_t> &);
+    void run();
+private:
+    static FvsError_t load(const FvsInt_t index, FvsPipelineData_t *data, FvsPointer_t context);
+    static void store(const FvsInt_t index, const FvsError_t result, FvsPipelineData_t *data,
+                      const FvsUint64_t *times, FvsPointer_t context);
+    QObject *receiver;
+    FvsBatch_t batch;
+    QStringList files;
+    QVector<FvsMinutiaSet_t> sets;
+};
+
+
+/* matches every batch image against all the others; the rows are library tasks */
+class MatchTask:public QRunnable{
+public:
+    MatchTask(QObject *,const QVector<FvsMinutiaSet_t> &,int *,QAtomicInt *);
+    void run();
+private:
+    static FvsBool_t rowDone(const FvsInt_t row, FvsPointer_t context);
+    QObject *receiver;
+    QVector<FvsMinutiaSet_t> sets;
+    int *scores;
+    QAtomicInt *cancel;
 };
 
 
@@ -38,15 +116,41 @@ class ProThread:public QThread{
     Q_OBJECT
 public:
     ProThread(QString,bool,double);
-    void setPicLabel(QLabel *,QLabel *,QLabel *,QLabel *,QLabel *,QLabel *,QLabel *);
+    ~ProThread();
+    void setFile(const QString &file);
+    bool setPipeline(const QString &text);
+    QString pipelineDescription() const;
+    void cancel();
     void run();
+signals:
+    void stageReady(int stage, const QImage &image);
+    void stageTimes(const QString &text);
+    void failed(const QString &message);
 private:
+    bool isCancelled();
+    static FvsBool_t stageDone(const FvsInt_t index, const char *name,
+                               FvsPipelineData_t *data, FvsPointer_t context);
+    static FvsBool_t pipelineCancelled(FvsPointer_t context);
+    void publishOutputs(FvsUint_t outputs, FvsPipelineData_t *data);
+    void publish(PipelineStage stage, const FvsImage_t image, const char *suffix);
     bool genPic;
     QString bmpfilename;
     const static int defaultSetSize=1200;
+    static const char *defaultPipeline;
     double radius;
-    QLabel *originLabel,*directionLabel,*maskLabel,*enhanceLabel,*binarizeLabel,*thinningLabel,*minutiaLabel;
+    QAtomicInt cancelFlag;
+    /* stages assembled from the description, see pipeline.h */
+    FvsPipeline_t pipeline;
+    QString description;
+    int doneStages;
+    /* working buffers, kept between runs; viewimage only holds what is shown */
+    FvsImage_t mask, image, viewimage;
+    FvsBitImage_t bits;
+    FvsFloatField_t direction, frequency;
     FvsMinutiaSet_t minutiaSet;
+    FvsByte_t bmfh[14];
+    BITMAPINFOHEADER bmih;
+    RGBQUAD rgbq[256];
 };
 
 